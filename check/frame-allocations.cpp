@@ -0,0 +1,314 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Check of the heap allocations in the steady frames
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+
+#include <GLES2/gl2.h>
+
+#include "../src/timer-wheel.h"
+#include "../src/allocation-stats.h"
+#include "../src/glesly-main.h"
+#include "../src/headless-target.h"
+#include "../src/rectangle-object.h"
+#include "../src/generic-rectangle.h"
+#include "../src/shader.h"
+
+#if !CONFIG_ALLOCATION_ACCOUNTING
+#error "the allocations are counted by the library: CONFIG_ALLOCATION_ACCOUNTING must be set"
+#endif
+
+SYS_DEFINE_MODULE(DM_GLESLY);
+
+using namespace Glesly;
+
+/// The timer steps of the frames, see \ref Render::Timer()
+/*! The periodic timers are added again after each step, as the Timer Thread does. The periods
+ *  divide the turn of the highest level, so the wheel repeats itself in each turn, and the
+ *  vectors of all the slots have their final capacity after the first one. */
+static bool CheckTimerWheel(void)
+{
+ TimerWheel wheel;
+ std::vector<TimerWheel::Entry> due;
+
+ static const uint64_t periods[] = { 1, 2, 4, 8, 16, 64, 256, 1024, 4096, 65536 };
+ static const unsigned PERIODS = sizeof(periods) / sizeof(periods[0]);
+
+ for (unsigned i = 0; i < 100; ++i) {
+    TimerWheel::Entry entry;
+    entry.generation = i;
+    entry.period = periods[i % PERIODS];
+    entry.due = entry.period + i;
+    wheel.Add(entry);
+ }
+
+ const uint64_t turn = (uint64_t)TimerWheel::SLOTS * TimerWheel::SLOTS * TimerWheel::SLOTS;
+
+ unsigned long failed = 0;
+
+ for (uint64_t tick = 1; tick <= 2 * turn; ++tick) {
+    uint64_t before = AllocationStats::GetCount(AllocationStats::SUBSYSTEM_OTHER);
+
+    due.clear();
+    wheel.Advance(tick, due);
+    for (std::vector<TimerWheel::Entry>::iterator i = due.begin(); i != due.end(); ++i) {
+        i->due = tick + i->period;
+        wheel.Add(*i);
+    }
+
+    unsigned long count = AllocationStats::GetCount(AllocationStats::SUBSYSTEM_OTHER) - before;
+    if (tick > turn && count) {
+        if (!failed) {
+            fprintf(stderr, "TimerWheel: %lu allocations at tick %llu\n", count, (unsigned long long)tick);
+        }
+        failed += count;
+    }
+ }
+
+ if (failed) {
+    fprintf(stderr, "TimerWheel: %lu allocations in the steady state\n", failed);
+    return false;
+ }
+
+ printf("TimerWheel: no allocations in %llu steady frames\n", (unsigned long long)turn);
+ return true;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     The reference scene:                                                              *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+static const char sceneVertexShader[] =
+    "attribute vec3 position;\n"
+    "attribute vec2 texcoord;\n"
+    "uniform mat4 camera_matrix;\n"
+    "uniform mat4 p_matrix;\n"
+    "varying vec2 v_texcoord;\n"
+    "void main() {\n"
+    "    v_texcoord = texcoord;\n"
+    "    gl_Position = camera_matrix * p_matrix * vec4(position, 1.0);\n"
+    "}\n";
+
+static const char sceneFragmentShader[] =
+    "precision mediump float;\n"
+    "varying vec2 v_texcoord;\n"
+    "void main() {\n"
+    "    gl_FragColor = vec4(v_texcoord, 0.5, 1.0);\n"
+    "}\n";
+
+/// The frames drawn before the counting, the pools and the vectors are filled meanwhile
+/*! It is more than one turn of the lowest level of the \ref TimerWheel, so the buffers of its
+ *  slots are in circulation. */
+static constexpr unsigned SCENE_WARMUP_FRAMES = 1000;
+
+/// The frames counted
+static constexpr unsigned SCENE_STEADY_FRAMES = 200;
+
+/// The number of the rectangles
+static constexpr unsigned SCENE_OBJECTS = 64;
+
+/// A rotating rectangle with a registered timer and callbacks
+class SceneObject: public RectangleObject<2, 2>, private _RectangleInit
+{
+ public:
+    static ObjectPtr Create(Render & render, unsigned index)
+    {
+        return ObjectBase::Allocate<SceneObject>(render, index);
+    }
+
+ protected:
+    SceneObject(Render & render, unsigned index):
+        RectangleObject<2, 2>(render),
+        myIndex(index),
+        mySteps(0),
+        myCallback(new Callback)
+    {
+        RectangleVerticesInit(position, texcoord, elements);
+
+        // Half of them in each frame, the others by the timer wheel:
+        if (index & 1) {
+            SetTimerPeriod(TIMER_EVERY_FRAME);
+        } else {
+            SetTimerPeriod(10 * Clock::NSEC_PER_MSEC * (1 + index % 4));
+        }
+    }
+
+    virtual void Timer(void) override
+    {
+        ++mySteps;
+
+        Transformation & projection = GetNextProjection();
+        projection.RotateZ(0.01f * mySteps, 0.1f);
+        projection.Move(0.2f * (myIndex % 8) - 0.7f, 0.2f * (myIndex / 8) - 0.7f, 0.0f);
+
+        if (!(mySteps % 4)) {
+            Execute(myCallback, (mySteps % 8) ? CALLBACK_PRIORITY_NORMAL : CALLBACK_PRIORITY_HIGH);
+        }
+    }
+
+ private:
+    /// A callback doing nothing, executed by the Render Thread
+    class Callback: public ObjectCallback
+    {
+     private:
+        virtual bool Execute(ObjectBase &) override
+        {
+            return true; // Once only
+        }
+
+    }; // class Callback
+
+    unsigned myIndex;
+
+    unsigned mySteps;
+
+    /// Created once, the requests refer to it
+    ObjectCallbackPtr myCallback;
+
+}; // class SceneObject
+
+class SceneRender: public Render
+{
+ public:
+    SceneRender(CameraMatrix & camera):
+        Render(camera),
+        myFrames(0),
+        myStart(),
+        myEnd()
+    {
+        SetTimerMode(TIMER_MODE_REGISTERED);
+    }
+
+    virtual void UseShaders(void) override
+    {
+        AddShader(Shader::CreateBuiltIn(GL_VERTEX_SHADER, sceneVertexShader));
+        AddShader(Shader::CreateBuiltIn(GL_FRAGMENT_SHADER, sceneFragmentShader));
+    }
+
+    inline bool IsFinished(void) const
+    {
+        return myFrames.load() >= SCENE_WARMUP_FRAMES + SCENE_STEADY_FRAMES;
+    }
+
+    /// The allocations of the subsystem in the steady frames
+    inline uint64_t GetAllocations(AllocationStats::Subsystem subsystem) const
+    {
+        return myEnd[subsystem] - myStart[subsystem];
+    }
+
+ protected:
+    virtual void Frame(const SYS::TimeDelay &) override
+    {
+        unsigned frame = ++myFrames;
+        if (frame == SCENE_WARMUP_FRAMES) {
+            Count(myStart);
+        } else if (frame == SCENE_WARMUP_FRAMES + SCENE_STEADY_FRAMES) {
+            Count(myEnd);
+        }
+    }
+
+ private:
+    static inline void Count(uint64_t * counts)
+    {
+        for (unsigned i = 0; i < AllocationStats::SUBSYSTEM_MAX; ++i) {
+            counts[i] = AllocationStats::GetCount((AllocationStats::Subsystem)i);
+        }
+    }
+
+    std::atomic<unsigned> myFrames;
+
+    uint64_t myStart[AllocationStats::SUBSYSTEM_MAX];
+
+    uint64_t myEnd[AllocationStats::SUBSYSTEM_MAX];
+
+}; // class SceneRender
+
+class Scene: public Main
+{
+ public:
+    Scene(TargetPtr & target):
+        Main(target),
+        myRender(new SceneRender(myViewMatrix))
+    {
+    }
+
+    virtual void Initialize(void) override
+    {
+        AppendRenderer(myRender);
+
+        ObjectListBase::ObjectListInternal list = myRender->GetObjectList();
+        for (unsigned i = 0; i < SCENE_OBJECTS; ++i) {
+            list.Append(SceneObject::Create(*myRender, i));
+        }
+    }
+
+    virtual void Cleanup(void) override
+    {
+        myTimer->Kill();
+        timerSemaphore.Post();
+    }
+
+    virtual void CloseRequest(void) override
+    {
+        // The scene is finished by the frame counter
+    }
+
+    inline const SceneRender & GetRender(void) const
+    {
+        return *myRender;
+    }
+
+ protected:
+    virtual bool ToBeFinished(void) const override
+    {
+        return myRender->IsFinished();
+    }
+
+ private:
+    MEM::shared_ptr<SceneRender> myRender;
+
+}; // class Scene
+
+/// Draws rotating rectangles with timers and callbacks on a headless target
+/*! The allocations of the Render Thread and the Timer Thread are counted after the warmup. */
+static bool CheckReferenceScene(void)
+{
+ TargetPtr target(new HeadlessTarget(320, 240));
+
+ Scene scene(target);
+ scene.SetFrameScheduler(FrameSchedulerPtr(new FixedRateScheduler(1000)));
+ scene.Run();
+
+ uint64_t render = scene.GetRender().GetAllocations(AllocationStats::SUBSYSTEM_RENDER);
+ uint64_t timer = scene.GetRender().GetAllocations(AllocationStats::SUBSYSTEM_TIMER);
+
+ if (render || timer) {
+    fprintf(stderr, "Reference scene: %llu allocations in the Render Thread, %llu in the Timer Thread in %u steady frames\n", (unsigned long long)render, (unsigned long long)timer, SCENE_STEADY_FRAMES);
+    return false;
+ }
+
+ printf("Reference scene: no allocations in %u steady frames\n", SCENE_STEADY_FRAMES);
+ return true;
+}
+
+int main(void)
+{
+ bool ok = true;
+
+ ok = CheckTimerWheel() && ok;
+ ok = CheckReferenceScene() && ok;
+
+ return ok ? 0 : 1;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1 @@
+../../../src/allocation-stats.h
\ No newline at end of file
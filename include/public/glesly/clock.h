@@ -0,0 +1 @@
+../../../src/clock.h
\ No newline at end of file
@@ -20,6 +20,14 @@
 #define USE_SHADER_FILES    true
 #endif
 
+#ifndef CONFIG_FRAME_RATE
+#define CONFIG_FRAME_RATE   60
+#endif
+
+#ifndef CONFIG_ALLOCATION_ACCOUNTING
+#define CONFIG_ALLOCATION_ACCOUNTING    0
+#endif
+
 #endif /* __GLESLY_INCLUDE_PUBLIC_GLESLY_CONFIG_H_INCLUDED__ */
 
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1 @@
+../../../src/damage.h
\ No newline at end of file
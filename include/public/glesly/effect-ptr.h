@@ -20,7 +20,31 @@ namespace Glesly
 
     typedef MEM::shared_ptr<LayerChangeEffectBase> LayerEffectPtr;
 
-    typedef std::stack<LayerEffectPtr> ObjectLayerStack;
+    /// The stack of the layers, the top one is displayed
+    /*! The buried layers can also be accessed, see \ref ObjectsWithEffect::SetEvictionDepth(). */
+    class ObjectLayerStack: public std::stack<LayerEffectPtr>
+    {
+     public:
+        typedef container_type::iterator iterator;
+
+        /// The bottom layer
+        inline iterator begin(void)
+        {
+            return c.begin();
+        }
+
+        inline iterator end(void)
+        {
+            return c.end();
+        }
+
+        /// The layer at the given depth, 0 means the top one
+        inline LayerEffectPtr & GetLayer(size_t depth)
+        {
+            return c[c.size() - 1 - depth];
+        }
+
+    }; // class ObjectLayerStack
 
     class LayerEffectCreatorBase;
 
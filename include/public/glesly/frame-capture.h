@@ -0,0 +1 @@
+../../../src/frame-capture.h
\ No newline at end of file
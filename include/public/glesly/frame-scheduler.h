@@ -0,0 +1 @@
+../../../src/frame-scheduler.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/frame-statistics.h
\ No newline at end of file
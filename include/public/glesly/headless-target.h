@@ -0,0 +1 @@
+../../../src/headless-target.h
\ No newline at end of file
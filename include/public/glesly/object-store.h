@@ -0,0 +1 @@
+../../../src/object-store.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/pool-allocator.h
\ No newline at end of file
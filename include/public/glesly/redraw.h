@@ -0,0 +1 @@
+../../../src/redraw.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/resolution-scaler.h
\ No newline at end of file
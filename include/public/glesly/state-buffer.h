@@ -0,0 +1 @@
+../../../src/state-buffer.h
\ No newline at end of file
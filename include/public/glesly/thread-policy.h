@@ -0,0 +1 @@
+../../../src/thread-policy.h
\ No newline at end of file
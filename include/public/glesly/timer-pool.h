@@ -0,0 +1 @@
+../../../src/timer-pool.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/timer-wheel.h
\ No newline at end of file
@@ -0,0 +1,103 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Accounting of the heap allocations
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdlib.h>
+#include <new>
+
+#include "allocation-stats.h"
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class AllocationStats:                                                            *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+thread_local AllocationStats::Subsystem AllocationStats::myActual = AllocationStats::SUBSYSTEM_OTHER;
+
+std::atomic<uint64_t> AllocationStats::myCounts[SUBSYSTEM_MAX];
+
+std::atomic<uint64_t> AllocationStats::myBytes[SUBSYSTEM_MAX];
+
+const char * AllocationStats::GetName(Subsystem subsystem)
+{
+ switch (subsystem) {
+    case SUBSYSTEM_OTHER:
+        return "other";
+    case SUBSYSTEM_RENDER:
+        return "render";
+    case SUBSYSTEM_TIMER:
+        return "timer";
+    default:
+        return "?";
+ }
+}
+
+#if CONFIG_ALLOCATION_ACCOUNTING
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     The replaced global allocation functions:                                         *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+void * operator new(size_t size)
+{
+ AllocationStats::Add(size);
+
+ void * p = malloc(size ? size : 1);
+ if (!p) {
+    throw std::bad_alloc();
+ }
+
+ return p;
+}
+
+void * operator new[](size_t size)
+{
+ return operator new(size);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+ AllocationStats::Add(size);
+
+ return malloc(size ? size : 1);
+}
+
+void * operator new[](size_t size, const std::nothrow_t & tag) noexcept
+{
+ return operator new(size, tag);
+}
+
+void operator delete(void * p) noexcept
+{
+ free(p);
+}
+
+void operator delete[](void * p) noexcept
+{
+ free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+ free(p);
+}
+
+void operator delete[](void * p, size_t) noexcept
+{
+ free(p);
+}
+
+#endif /* CONFIG_ALLOCATION_ACCOUNTING */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,105 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Accounting of the heap allocations
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_ALLOCATION_STATS_H_INCLUDED__
+#define __GLESLY_SRC_ALLOCATION_STATS_H_INCLUDED__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+#include <glesly/config.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// Counters of the heap allocations, per subsystem
+    /*! If \ref CONFIG_ALLOCATION_ACCOUNTING is set, the global operator new is replaced, and each
+     *  allocation is accounted to the subsystem of the calling thread, see
+     *  \ref AllocationStats::Scope. Otherwise the counters remain zero.<br>
+     *  In a steady state, the frames should not allocate at all: \ref Main::Run() checks it,
+     *  see \ref Main::GetFrameAllocations(). */
+    class AllocationStats
+    {
+     public:
+        enum Subsystem
+        {
+            SUBSYSTEM_OTHER = 0,    ///< Not in any \ref AllocationStats::Scope
+            SUBSYSTEM_RENDER,       ///< The frame loop of the Render Thread
+            SUBSYSTEM_TIMER,        ///< The timer functions, see \ref Render::Timer()
+            SUBSYSTEM_MAX
+
+        }; // enum Glesly::AllocationStats::Subsystem
+
+        /// Accounts the allocations of the calling thread to the given subsystem while it exists
+        /*! The scopes can be nested, the innermost one is used. */
+        class Scope
+        {
+         public:
+            inline Scope(Subsystem subsystem):
+                myPrevious(myActual)
+            {
+                myActual = subsystem;
+            }
+
+            inline ~Scope()
+            {
+                myActual = myPrevious;
+            }
+
+         private:
+            Subsystem myPrevious;
+
+        }; // class Glesly::AllocationStats::Scope
+
+        /// The number of allocations in the subsystem
+        static inline uint64_t GetCount(Subsystem subsystem)
+        {
+            return myCounts[subsystem].load(std::memory_order_relaxed);
+        }
+
+        /// The number of allocated bytes in the subsystem
+        static inline uint64_t GetBytes(Subsystem subsystem)
+        {
+            return myBytes[subsystem].load(std::memory_order_relaxed);
+        }
+
+        static inline bool IsEnabled(void)
+        {
+            return CONFIG_ALLOCATION_ACCOUNTING;
+        }
+
+        /// Accounts one allocation, called by the operator new
+        static inline void Add(size_t size)
+        {
+            myCounts[myActual].fetch_add(1, std::memory_order_relaxed);
+            myBytes[myActual].fetch_add(size, std::memory_order_relaxed);
+        }
+
+        static const char * GetName(Subsystem subsystem);
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::AllocationStats");
+
+        static thread_local Subsystem myActual;
+
+        static std::atomic<uint64_t> myCounts[SUBSYSTEM_MAX];
+
+        static std::atomic<uint64_t> myBytes[SUBSYSTEM_MAX];
+
+    }; // class AllocationStats
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_ALLOCATION_STATS_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
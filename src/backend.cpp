@@ -10,7 +10,12 @@
 
 #include "backend.h"
 
+#include <string.h>
+#include <EGL/eglext.h>
+
 #include <glesly/error.h>
+#include <glesly/redraw.h>
+#include <glesly/pool-allocator.h>
 
 using namespace Glesly;
 
@@ -27,7 +32,9 @@ Backend::Backend(void):
     myDisplay(0),
     myConfig(0),
     mySurface(0),
-    myContext(0)
+    myContext(0),
+    hasBufferAge(false),
+    mySwapWithDamage(NULL)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 }
@@ -82,6 +89,7 @@ void Backend::Initialize(void)
 
  InitDisplay();
  InitSurface();
+ InitExtensions();
 }
 
 void Backend::Cleanup(void)
@@ -97,6 +105,9 @@ void Backend::Cleanup(void)
 void Backend::CloseRequest(void)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ Redraw::Request();
+
  if (myParent) {
     myParent->CloseRequest();
  }
@@ -105,6 +116,9 @@ void Backend::CloseRequest(void)
 void Backend::MouseClick(int x, int y, int index, int count)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ Redraw::Request();
+
  if (myParent) {
     myParent->MouseClick(x, y, index, count);
  }
@@ -122,18 +136,8 @@ void Backend::InitDisplay(void)
  if (eglGetError() != EGL_SUCCESS) {
     throw Error("Could not eglBindAPI()");
  }
- EGLint attribs[] = {
-    EGL_SURFACE_TYPE,       EGL_WINDOW_BIT,
-    EGL_RENDERABLE_TYPE,    EGL_OPENGL_ES2_BIT,
-    EGL_RED_SIZE,           5,
-    EGL_GREEN_SIZE,         6,
-    EGL_BLUE_SIZE,          5,
-    EGL_ALPHA_SIZE,         0,
-    EGL_DEPTH_SIZE,         16,
-    EGL_NONE
- };
  int configs;
- if (!eglChooseConfig(myDisplay, attribs, &myConfig, 1, &configs) || (configs != 1)) {
+ if (!eglChooseConfig(myDisplay, myTarget->GetEGLConfigAttribs(), &myConfig, 1, &configs) || (configs != 1)) {
     throw Error("Could not eglChooseConfig()");
  }
 }
@@ -157,7 +161,50 @@ void Backend::InitSurface(void)
  }
 }
 
-void Backend::SwapBuffers(void)
+/// Detects the optional EGL extensions used by the partial redraw
+void Backend::InitExtensions(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ const char * extensions = eglQueryString(myDisplay, EGL_EXTENSIONS);
+ if (!extensions) {
+    return;
+ }
+
+ hasBufferAge = strstr(extensions, "EGL_EXT_buffer_age") != NULL;
+
+ if (strstr(extensions, "EGL_KHR_swap_buffers_with_damage")) {
+    mySwapWithDamage = (SwapWithDamageFunction)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+ } else if (strstr(extensions, "EGL_EXT_swap_buffers_with_damage")) {
+    mySwapWithDamage = (SwapWithDamageFunction)eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+ }
+
+ SYS_DEBUG(DL_INFO1, "Buffer age: " << (hasBufferAge ? "yes" : "no") << ", swap with damage: " << (mySwapWithDamage ? "yes" : "no"));
+}
+
+/// Queries the age of the back buffer
+/*! \retval The number of frames since the back buffer has been drawn: 1 means it contains the
+ *          previous frame. 0 means that its content is undefined, or the age is not known. */
+int Backend::QueryBufferAge(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!hasBufferAge) {
+    return 0;
+ }
+
+ EGLint age = 0;
+ if (!eglQuerySurface(myDisplay, mySurface, EGL_BUFFER_AGE_EXT, &age)) {
+    return 0;
+ }
+
+ return age;
+}
+
+/// Shows the back buffer
+/*! \param  damage  The area changed since the previous frame, or NULL if it is not known. It is
+ *                  passed to the compositor if EGL_KHR_swap_buffers_with_damage is supported. */
+void Backend::SwapBuffers(const DamageRect * damage)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
@@ -171,12 +218,19 @@ void Backend::SwapBuffers(void)
 
  Threads::Lock _l(target->GetGraphicMutex());
 
- eglSwapBuffers(myDisplay, mySurface);
+ if (damage && mySwapWithDamage) {
+    EGLint rect[4] = { damage->x, damage->y, damage->width, damage->height };
+    mySwapWithDamage(myDisplay, mySurface, rect, 1);
+ } else {
+    eglSwapBuffers(myDisplay, mySurface);
+ }
  if (eglGetError() != EGL_SUCCESS) {
     throw Error("Could not eglSwapBuffers()");
  }
 }
 
+/// Locks the graphic resources of the target while the returned lock exists
+/*! The lock and its control block are allocated from a pool, so it can be used in each frame. */
 Threads::LockPtr Backend::GetGraphicalLock(void)
 {
  Glesly::TargetPtr target = GetTarget();
@@ -185,7 +239,7 @@ Threads::LockPtr Backend::GetGraphicalLock(void)
     return Threads::LockPtr();
  }
 
- return Threads::LockPtr(new Threads::Lock(target->GetGraphicMutex()));
+ return std::allocate_shared<Threads::Lock>(PoolAllocator<Threads::Lock>(), target->GetGraphicMutex());
 }
 
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
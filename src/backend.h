@@ -15,6 +15,7 @@
 #include <EGL/egl.h>
 
 #include <glesly/target.h>
+#include <glesly/damage.h>
 
 SYS_DECLARE_MODULE(DM_GLESLY);
 
@@ -29,7 +30,8 @@ namespace Glesly
         Backend(TargetPtr & target);
         virtual ~Backend();
 
-        void SwapBuffers(void);
+        void SwapBuffers(const Glesly::DamageRect * damage = NULL);
+        int QueryBufferAge(void);
         void Initialize(void);
         void Cleanup(void);
         void Retarget(TargetPtr & target);
@@ -45,6 +47,12 @@ namespace Glesly
             return (bool)myTarget;
         }
 
+        /// Tells if the age of the back buffer can be queried (EGL_EXT_buffer_age)
+        inline bool HasBufferAge(void) const
+        {
+            return hasBufferAge;
+        }
+
         inline void RegisterParent(TargetHolder * parent = NULL)
         {
             myParent = parent;
@@ -65,6 +73,15 @@ namespace Glesly
      private:
         SYS_DEFINE_CLASS_NAME("Glesly::Backend");
 
+        typedef EGLBoolean (*SwapWithDamageFunction)(EGLDisplay dpy, EGLSurface surface, EGLint * rects, EGLint n_rects);
+
+        void InitExtensions(void);
+
+        bool hasBufferAge;
+
+        /// eglSwapBuffersWithDamageKHR() or eglSwapBuffersWithDamageEXT(), if available
+        SwapWithDamageFunction mySwapWithDamage;
+
         virtual void CloseRequest(void) override;
         virtual void MouseClick(int x, int y, int index, int count) override;
 
@@ -46,6 +46,8 @@ void CameraMatrix::Update(void)
     0.0f,   0.0f,   r_z,    1.0f,
     0.0f,   0.0f,   r_w,    0.0f
  };
+
+ Redraw::Request();
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
@@ -79,6 +81,8 @@ void Transformation::RotateX(float angle, float scale)
  (*this)[2][0] = 0.0f;
  (*this)[2][1] = -s;
  (*this)[2][2] = c;
+
+ Redraw::Request();
 }
 
 void Transformation::RotateY(float angle, float scale)
@@ -97,6 +101,8 @@ void Transformation::RotateY(float angle, float scale)
  (*this)[2][0] = -s;
  (*this)[2][1] = 0.0f;
  (*this)[2][2] = c;
+
+ Redraw::Request();
 }
 
 void Transformation::RotateZ(float angle, float scale)
@@ -115,6 +121,8 @@ void Transformation::RotateZ(float angle, float scale)
  (*this)[2][0] = 0.0f;
  (*this)[2][1] = 0.0f;
  (*this)[2][2] = scale;
+
+ Redraw::Request();
 }
 
 void Transformation::RotateZ(float angle, float scale, float aspect)
@@ -133,6 +141,8 @@ void Transformation::RotateZ(float angle, float scale, float aspect)
  (*this)[2][0] = 0.0f;
  (*this)[2][1] = 0.0f;
  (*this)[2][2] = scale;
+
+ Redraw::Request();
 }
 
 void Transformation::Move(float x, float y, float z)
@@ -140,6 +150,8 @@ void Transformation::Move(float x, float y, float z)
  (*this)[3][0] = x;
  (*this)[3][1] = y;
  (*this)[3][2] = z;
+
+ Redraw::Request();
 }
 
 bool Transformation::ConvertMouseCoordinates(float & x, float & y) const
@@ -163,4 +175,25 @@ bool Transformation::ConvertMouseCoordinates(float & x, float & y) const
  return true;
 }
 
+/// Linear blend of two transformations
+/*! It is used to interpolate between two simulation steps, see \ref InterpolatedState. The
+ *  elements are blended one by one, it is accurate enough for the small changes of one step.
+ *  \param  from    The result at alpha = 0.
+ *  \param  to      The result at alpha = 1.
+ *  \param  alpha   The interpolation factor.
+ *  \note   It does not call \ref Redraw::Request(), the change has been requested already when
+ *          the state was committed. */
+void Transformation::Blend(const Transformation & from, const Transformation & to, float alpha)
+{
+ for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+        (*this)[i][j] = from[i][j] + (to[i][j] - from[i][j]) * alpha;
+    }
+ }
+
+ xAngle = from.xAngle + (to.xAngle - from.xAngle) * alpha;
+ yAngle = from.yAngle + (to.yAngle - from.yAngle) * alpha;
+ zAngle = from.zAngle + (to.zAngle - from.zAngle) * alpha;
+}
+
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -13,6 +13,7 @@
 
 #include <glesly/math/vector.h>
 #include <glesly/math/matrix.h>
+#include <glesly/redraw.h>
 
 namespace Glesly
 {
@@ -78,11 +79,14 @@ namespace Glesly
         Transformation & operator=(const Glesly::Matrix<float, 4, 4> & other)
         {
             Glesly::Matrix<float, 4, 4>::operator=(other);
+            Redraw::Request();
             return *this;
         }
 
         bool ConvertMouseCoordinates(float & x, float & y) const;
 
+        void Blend(const Transformation & from, const Transformation & to, float alpha);
+
         void RotateX(float angle, float scale = 1.0f);
         void RotateY(float angle, float scale = 1.0f);
         void RotateZ(float angle, float scale = 1.0f);
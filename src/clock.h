@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Monotonic clock helpers for frame timing
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_CLOCK_H_INCLUDED__
+#define __GLESLY_SRC_CLOCK_H_INCLUDED__
+
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+
+namespace Glesly
+{
+    /// Nanosecond-resolution monotonic clock
+    /*! All the frame timing (deadlines, statistics) is based on CLOCK_MONOTONIC, so it is not
+     *  affected by setting the system time. */
+    class Clock
+    {
+     public:
+        static constexpr int64_t NSEC_PER_USEC  = 1000LL;
+        static constexpr int64_t NSEC_PER_MSEC  = 1000000LL;
+        static constexpr int64_t NSEC_PER_SEC   = 1000000000LL;
+
+        /// Returns the actual time in nanoseconds
+        static inline int64_t Now(void)
+        {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return (int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+        }
+
+        /// Sleeps until the given absolute time
+        /*! The absolute deadline prevents the drift caused by relative sleeps: the time spent
+         *  between the calculation and the sleep itself does not accumulate. */
+        static inline void SleepUntil(int64_t deadline)
+        {
+            struct timespec ts;
+            ts.tv_sec = deadline / NSEC_PER_SEC;
+            ts.tv_nsec = deadline % NSEC_PER_SEC;
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+                // Interrupted by a signal: continue waiting
+            }
+        }
+
+    }; // class Clock
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_CLOCK_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
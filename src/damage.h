@@ -0,0 +1,170 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Screen areas to be redrawn
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_DAMAGE_H_INCLUDED__
+#define __GLESLY_SRC_DAMAGE_H_INCLUDED__
+
+#include <stdint.h>
+#include <algorithm>
+
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// A rectangle on the screen
+    /*! The coordinates are in pixels, with bottom-left origin, like in glScissor() and in
+     *  eglSwapBuffersWithDamageKHR(). A rectangle with zero width or height is empty. */
+    struct DamageRect
+    {
+        inline DamageRect(void):
+            x(0),
+            y(0),
+            width(0),
+            height(0)
+        {
+        }
+
+        inline DamageRect(int p_x, int p_y, int p_width, int p_height):
+            x(p_x),
+            y(p_y),
+            width(p_width),
+            height(p_height)
+        {
+        }
+
+        inline bool IsEmpty(void) const
+        {
+            return width <= 0 || height <= 0;
+        }
+
+        /// The bounding rectangle of this and the other one
+        inline DamageRect & Add(const DamageRect & other)
+        {
+            if (other.IsEmpty()) {
+                return *this;
+            }
+            if (IsEmpty()) {
+                return *this = other;
+            }
+            int right = std::max(x + width, other.x + other.width);
+            int top = std::max(y + height, other.y + other.height);
+            x = std::min(x, other.x);
+            y = std::min(y, other.y);
+            width = right - x;
+            height = top - y;
+            return *this;
+        }
+
+        /// Limits the rectangle into the screen
+        inline DamageRect & Clip(int screen_width, int screen_height)
+        {
+            int right = std::min(x + width, screen_width);
+            int top = std::min(y + height, screen_height);
+            x = std::max(x, 0);
+            y = std::max(y, 0);
+            width = std::max(right - x, 0);
+            height = std::max(top - y, 0);
+            return *this;
+        }
+
+        inline bool Intersects(const DamageRect & other) const
+        {
+            return x < other.x + other.width && other.x < x + width && y < other.y + other.height && other.y < y + height;
+        }
+
+        inline bool Covers(const DamageRect & other) const
+        {
+            return x <= other.x && y <= other.y && x + width >= other.x + other.width && y + height >= other.y + other.height;
+        }
+
+        /// Packs the rectangle into one integer
+        /*! It is used to store the rectangle atomically. Each coordinate is limited to 16 bits. */
+        inline uint64_t Pack(void) const
+        {
+            return (uint64_t)(uint16_t)x | ((uint64_t)(uint16_t)y << 16) | ((uint64_t)(uint16_t)width << 32) | ((uint64_t)(uint16_t)height << 48);
+        }
+
+        static inline DamageRect Unpack(uint64_t packed)
+        {
+            return DamageRect((int16_t)(packed & 0xffff), (int16_t)((packed >> 16) & 0xffff), (int16_t)((packed >> 32) & 0xffff), (int16_t)((packed >> 48) & 0xffff));
+        }
+
+        int x;
+
+        int y;
+
+        int width;
+
+        int height;
+
+    }; // struct DamageRect
+
+    /// The damaged areas of the last few frames
+    /*! If the back buffer is reused (see EGL_EXT_buffer_age), it contains the image of an older
+     *  frame, so the areas damaged since that frame must also be redrawn. */
+    class DamageHistory
+    {
+     public:
+        inline DamageHistory(void):
+            myNext(0)
+        {
+        }
+
+        /// Calculates the area to be redrawn
+        /*! \param  damage  The area damaged since the previous frame.
+         *  \param  age     The age of the back buffer: 1 if it contains the previous frame, 0 if
+         *                  its content is undefined.
+         *  \param  full    The whole screen.
+         *  \retval The area to be redrawn. */
+        inline DamageRect GetRepaintArea(const DamageRect & damage, int age, const DamageRect & full) const
+        {
+            if (age <= 0 || age > HISTORY_SIZE + 1) {
+                return full;
+            }
+            DamageRect result(damage);
+            for (int i = 1; i < age; ++i) {
+                result.Add(myFrames[(myNext + HISTORY_SIZE - i) % HISTORY_SIZE]);
+            }
+            return result;
+        }
+
+        /// Stores the damage of the actual frame
+        inline void Push(const DamageRect & damage)
+        {
+            myFrames[myNext] = damage;
+            myNext = (myNext + 1) % HISTORY_SIZE;
+        }
+
+        /// Treats all of the previous frames as fully damaged
+        inline void Reset(const DamageRect & full)
+        {
+            for (int i = 0; i < HISTORY_SIZE; ++i) {
+                myFrames[i] = full;
+            }
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::DamageHistory");
+
+        static constexpr int HISTORY_SIZE = 4;
+
+        DamageRect myFrames[HISTORY_SIZE];
+
+        int myNext;
+
+    }; // class DamageHistory
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_DAMAGE_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
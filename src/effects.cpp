@@ -49,11 +49,57 @@ void LayerChangeEffectBase::Frame(const SYS::TimeDelay & frame_start_time)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
- for (ObjectListIterator i = previousObjects->begin(); i != previousObjects->end(); ++i) {
-    (*i)->DrawFrame(frame_start_time);
+ Objects::Reader objects(*previousObjects);
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    if ((*i)->IsGLInitialized()) {
+        (*i)->DrawFrame(frame_start_time);
+    }
  }
 }
 
+/// Releases the GL resources of the Objects of this layer (Render Thread)
+/*! \see ObjectBase::EvictGL() */
+void LayerChangeEffectBase::Evict(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (isEvicted) {
+    return;
+ }
+
+ Objects::Reader objects(*myObjects);
+
+ SYS_DEBUG(DL_INFO1, "Evicting " << objects.size() << " objects");
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    (*i)->EvictGL();
+ }
+
+ isEvicted = true;
+}
+
+/// Requests the GL initialization of the evicted Objects of this layer (Render Thread)
+/*! \see ObjectBase::RestoreGL() */
+void LayerChangeEffectBase::Restore(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!isEvicted) {
+    return;
+ }
+
+ Objects::Reader objects(*myObjects);
+
+ SYS_DEBUG(DL_INFO1, "Restoring " << objects.size() << " objects");
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    (*i)->RestoreGL();
+ }
+
+ isEvicted = false;
+}
+
 bool LayerChangeEffectBase::Step(Glesly::LayerChangeEffectBase::EffectParameters & params)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
@@ -62,6 +108,9 @@ bool LayerChangeEffectBase::Step(Glesly::LayerChangeEffectBase::EffectParameters
     return false;
  }
 
+ // The effect is animated, so the next frame is necessary too:
+ Redraw::Request();
+
  float state = 1e-3*(float)SYS::TimeElapsed(myStart).ToMillisecond()/myTime;
 
  SYS_DEBUG(DL_INFO2, "Layer Effect: State=" << state << ", " << (layerContainer ? "outgoing" : "incoming"));
@@ -16,6 +16,7 @@
 #include <System/TimeElapsed.h>
 #include <glesly/shader-uniforms.h>
 #include <glesly/object-ptr.h>
+#include <glesly/object-store.h>
 #include <glesly/effect-ptr.h>
 #include <glesly/camera.h>
 
@@ -106,12 +107,22 @@ namespace Glesly
             active = true;
         }
 
+        void Evict(void);
+        void Restore(void);
+
+        /// Tells if the GL resources of the layer have been released
+        inline bool IsEvicted(void) const
+        {
+            return isEvicted;
+        }
+
      protected:
         inline LayerChangeEffectBase(ObjectListPtr & objects, float time = 1.0):
-            myObjects(objects),
+            myObjects(objects ? objects : ObjectListPtr(new Objects)),
             active(false),
             myTime(time),
-            layerContainer(NULL)
+            layerContainer(NULL),
+            isEvicted(false)
         {
         }
 
@@ -130,6 +141,8 @@ namespace Glesly
 
         ObjectLayerStack * layerContainer;
 
+        bool isEvicted;
+
         void Frame(const SYS::TimeDelay & frame_start_time);
 
         virtual void SetState(Glesly::LayerChangeEffectBase::EffectParameters & params, float state) { }
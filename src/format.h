@@ -125,6 +125,29 @@ namespace Glesly
         return result;
     }
 
+    /// The size of one pixel in bytes
+    inline unsigned Format2PixelSize(PixelFormat format)
+    {
+        unsigned result = 0;
+        switch (format) {
+            case FORMAT_RGB_565:
+                result = 2;
+            break;
+            case FORMAT_RGB_888:
+            case FORMAT_BGR_888:
+                result = 3;
+            break;
+            case FORMAT_RGBA_8888:
+            case FORMAT_BGRA_8888:
+                result = 4;
+            break;
+            default:
+            break;
+        }
+        ASSERT(result, "unknown pixel format " << (int)format);
+        return result;
+    }
+
 } // namespace Glesly
 
 #endif /* __INCLUDE_PUBLIC_GLESLY_FORMAT_H_INCLUDED__ */
@@ -0,0 +1,188 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Asynchronous capture of the frames into TGA files
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "frame-capture.h"
+
+#include <stdio.h>
+#include <GLES2/gl2.h>
+
+#include <glesly/error.h>
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class FrameCapture:                                                               *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+FrameCapture::FrameCapture(const char * prefix, int width, int height, unsigned buffers):
+    Threads::Thread("FrameCapture"),
+    myPrefix(prefix),
+    myWidth(width),
+    myHeight(height),
+    myBuffers(buffers ? buffers : 1),
+    myFilled(0),
+    myEmptied(0),
+    isWaiting(false),
+    toBeFinished(false),
+    isBlocking(false),
+    myFrames(0),
+    myWritten(0),
+    myDropped(0)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ASSERT(width > 0 && height > 0, "invalid capture size: " << width << "x" << height);
+
+ size_t size = sizeof(ReadTGA::tga_header) + (size_t)width * height * sizeof(ReadTGA::pixel_data);
+
+ for (unsigned i = 0; i < myBuffers.size(); ++i) {
+    Buffer & buffer = myBuffers[i];
+    buffer.myFrame = 0;
+    buffer.myData.resize(size);
+    ReadTGA::tga_header * header = new (buffer.myData.data()) ReadTGA::tga_header(width, height, 32);
+    header->image_descriptor = 8; // 8-bit alpha, bottom-left origin like glReadPixels()
+ }
+}
+
+FrameCapture::~FrameCapture()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+/// Creates the capture object, and starts its thread
+/*! \param  prefix  The beginning of the file names, it can contain the path.
+ *  \param  width   The width of the captured area.
+ *  \param  height  The height of the captured area.
+ *  \param  buffers The number of preallocated frame buffers. */
+FrameCapturePtr FrameCapture::Create(const char * prefix, int width, int height, unsigned buffers)
+{
+ SYS_DEBUG_STATIC(DM_GLESLY);
+
+ FrameCapturePtr p(new FrameCapture(prefix, width, height, buffers));
+ p->Start(p, 4*65536);
+ return p;
+}
+
+/// Reads the actual framebuffer
+/*! It must be called from the Render Thread, after the frame has been drawn, but before
+ *  swapping the buffers. Only glReadPixels() is executed here. */
+void FrameCapture::Capture(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ unsigned long frame = myFrames++;
+ unsigned long filled = myFilled.load(std::memory_order_relaxed);
+
+ while (filled - myEmptied.load(std::memory_order_acquire) >= myBuffers.size()) {
+    if (!isBlocking || toBeFinished) {
+        ++myDropped;
+        SYS_DEBUG(DL_INFO2, "Frame #" << frame << " dropped");
+        return;
+    }
+    isWaiting = true;
+    if (filled - myEmptied.load() >= myBuffers.size()) {
+        myFreed.Wait();
+    }
+    isWaiting = false;
+ }
+
+ Buffer & buffer = myBuffers[filled % myBuffers.size()];
+
+ buffer.myFrame = frame;
+
+ glReadPixels(0, 0, myWidth, myHeight, GL_RGBA, GL_UNSIGNED_BYTE, buffer.GetHeader().image_data);
+ if (glGetError() != GL_NO_ERROR) {
+    throw Error("Could not glReadPixels()");
+ }
+
+ myFilled.store(filled + 1, std::memory_order_release);
+
+ myPending.Post();
+}
+
+/// Stops the capture thread
+/*! The frames already captured are written before the thread exits. */
+void FrameCapture::Finish(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ toBeFinished = true;
+
+ myPending.Post();
+}
+
+int FrameCapture::main(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ for (;;) {
+    myPending.Wait();
+
+    unsigned long emptied = myEmptied.load(std::memory_order_relaxed);
+
+    if (emptied == myFilled.load(std::memory_order_acquire)) {
+        if (toBeFinished || ToBeFinished()) {
+            break;
+        }
+        continue;
+    }
+
+    Write(myBuffers[emptied % myBuffers.size()]);
+
+    myEmptied.store(emptied + 1);
+
+    if (isWaiting) {
+        myFreed.Post();
+    }
+ }
+
+ SYS_DEBUG(DL_INFO1, "Frame capture finished: " << myWritten << " written, " << myDropped << " dropped");
+
+ return 0;
+}
+
+/// Writes one buffer into file
+/*! The pixels are converted from RGBA (read by OpenGL) to BGRA (used by TGA) in place. */
+void FrameCapture::Write(Buffer & buffer)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ReadTGA::pixel_data * pixel = buffer.GetHeader().GetPixelData_888();
+ ReadTGA::pixel_data * end = pixel + (size_t)myWidth * myHeight;
+
+ for ( ; pixel < end; ++pixel) {
+    uint8_t red = pixel->b;
+    pixel->b = pixel->r;
+    pixel->r = red;
+ }
+
+ char number[32];
+ snprintf(number, sizeof number, "%05lu.tga", buffer.myFrame);
+
+ std::string name = myPrefix + number;
+
+ FILE * file = fopen(name.c_str(), "wb");
+ if (!file) {
+    DEBUG_OUT("Could not open '" << name << "' to write the captured frame");
+    return;
+ }
+
+ if (fwrite(buffer.myData.data(), buffer.myData.size(), 1, file) != 1) {
+    DEBUG_OUT("Could not write the captured frame into '" << name << "'");
+ } else {
+    ++myWritten;
+ }
+
+ fclose(file);
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
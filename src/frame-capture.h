@@ -0,0 +1,130 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Asynchronous capture of the frames into TGA files
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_FRAME_CAPTURE_H_INCLUDED__
+#define __GLESLY_SRC_FRAME_CAPTURE_H_INCLUDED__
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <glesly/read-tga.h>
+#include <Threads/Threads.h>
+#include <Threads/Semaphore.h>
+#include <Memory/Memory.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    class FrameCapture;
+
+    typedef MEM::shared_ptr<FrameCapture> FrameCapturePtr;
+
+    /// Saves the rendered frames as a sequence of TGA files
+    /*! The Render Thread reads the framebuffer into one of the preallocated buffers by calling
+     *  \ref FrameCapture::Capture(), and the files are written by the capture thread. The file
+     *  names are made of the prefix and the frame number, e.g. "frame-00042.tga".<br>
+     *  If all of the buffers are in use, the frame is dropped and counted, unless the capture is
+     *  blocking (see \ref FrameCapture::SetBlocking()). The frame numbers count the dropped frames
+     *  too, so the missing files show the gaps. */
+    class FrameCapture: public Threads::Thread
+    {
+     public:
+        virtual ~FrameCapture();
+
+        static FrameCapturePtr Create(const char * prefix, int width, int height, unsigned buffers = 4);
+
+        void Capture(void);
+        void Finish(void);
+
+        /// Waits for a free buffer instead of dropping frames
+        /*! It is useful for offline video export, where the frame rate does not matter. */
+        inline void SetBlocking(bool blocking = true)
+        {
+            isBlocking = blocking;
+        }
+
+        /// The number of frames written to file
+        inline unsigned long GetWrittenFrames(void) const
+        {
+            return myWritten;
+        }
+
+        /// The number of frames dropped because all of the buffers were in use
+        inline unsigned long GetDroppedFrames(void) const
+        {
+            return myDropped;
+        }
+
+     protected:
+        FrameCapture(const char * prefix, int width, int height, unsigned buffers);
+
+        virtual int main(void) override;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::FrameCapture");
+
+        /// One captured frame
+        struct Buffer
+        {
+            unsigned long myFrame;
+
+            /// The TGA header, followed by the pixel data
+            std::vector<uint8_t> myData;
+
+            inline ReadTGA::tga_header & GetHeader(void)
+            {
+                return *reinterpret_cast<ReadTGA::tga_header *>(myData.data());
+            }
+
+        }; // struct Glesly::FrameCapture::Buffer
+
+        void Write(Buffer & buffer);
+
+        std::string myPrefix;
+
+        int myWidth;
+
+        int myHeight;
+
+        std::vector<Buffer> myBuffers;
+
+        /// The number of buffers filled by the Render Thread
+        std::atomic<unsigned long> myFilled;
+
+        /// The number of buffers written by the capture thread
+        std::atomic<unsigned long> myEmptied;
+
+        /// The Render Thread waits for a free buffer
+        std::atomic<bool> isWaiting;
+
+        Threads::Semaphore myPending;
+
+        Threads::Semaphore myFreed;
+
+        std::atomic<bool> toBeFinished;
+
+        bool isBlocking;
+
+        unsigned long myFrames;
+
+        std::atomic<unsigned long> myWritten;
+
+        std::atomic<unsigned long> myDropped;
+
+    }; // class FrameCapture
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_FRAME_CAPTURE_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,248 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Frame pacing of the Render Thread
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "frame-scheduler.h"
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class FrameScheduler:                                                             *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+FrameScheduler::FrameScheduler(unsigned rate):
+    myPeriod(0),
+    myFrames(0),
+    myMissed(0),
+    myRate(0)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ SetFrameRate(rate);
+}
+
+FrameScheduler::~FrameScheduler()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+/// Sets the nominal frame rate
+/*! \param  rate    The frame rate in Hz.
+ *  \note   It is allowed to call it while the frame loop is running, the new rate is used
+ *          from the next frame. */
+void FrameScheduler::SetFrameRate(unsigned rate)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ASSERT(rate > 0, "invalid frame rate: " << rate);
+
+ myRate = rate;
+ myPeriod = Clock::NSEC_PER_SEC / rate;
+
+ SYS_DEBUG(DL_INFO1, "Frame rate: " << rate << " Hz (" << myPeriod << " ns)");
+}
+
+void FrameScheduler::Start(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myFrames = 0;
+ myMissed = 0;
+ myWakeupLatency.Reset();
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class FixedRateScheduler:                                                         *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+FixedRateScheduler::FixedRateScheduler(unsigned rate):
+    FrameScheduler(rate),
+    myDeadline(0)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+FixedRateScheduler::~FixedRateScheduler()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+void FixedRateScheduler::Start(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ FrameScheduler::Start();
+
+ myDeadline = Clock::Now();
+}
+
+void FixedRateScheduler::Resume(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myDeadline = Clock::Now();
+}
+
+void FixedRateScheduler::WaitNextFrame(Glesly::Target &)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ WaitDeadline(myPeriod);
+}
+
+/// Waits for the next deadline
+/*! \param  period  The time between the actual and the next frame, in nanoseconds. */
+void FixedRateScheduler::WaitDeadline(int64_t period)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ++myFrames;
+
+ myDeadline += period;
+
+ int64_t now = Clock::Now();
+
+ if (now < myDeadline) {
+    Clock::SleepUntil(myDeadline);
+    myWakeupLatency.Add(Clock::Now() - myDeadline);
+    return;
+ }
+
+ // The frame ran late: skip the periods already elapsed, but keep the phase:
+ int64_t late = now - myDeadline;
+ int64_t skipped = late / period;
+
+ myDeadline += skipped * period;
+ myMissed += 1 + skipped;
+
+ SYS_DEBUG(DL_INFO2, "Frame deadline missed by " << late / Clock::NSEC_PER_USEC << " us, " << skipped << " frame(s) skipped");
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class VsyncScheduler:                                                             *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+VsyncScheduler::VsyncScheduler(unsigned rate):
+    FrameScheduler(rate),
+    myPrevious(0)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+VsyncScheduler::~VsyncScheduler()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+void VsyncScheduler::Start(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ FrameScheduler::Start();
+
+ myPrevious = Clock::Now();
+}
+
+void VsyncScheduler::Resume(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myPrevious = Clock::Now();
+}
+
+void VsyncScheduler::WaitNextFrame(Glesly::Target & target)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ target.Wait4Sync();
+
+ ++myFrames;
+
+ int64_t now = Clock::Now();
+ int64_t interval = now - myPrevious;
+ myPrevious = now;
+
+ // More than one and a half period means that at least one sync has been lost:
+ if (interval > myPeriod + myPeriod / 2) {
+    int64_t lost = (interval + myPeriod / 2) / myPeriod - 1;
+    myMissed += lost;
+    SYS_DEBUG(DL_INFO2, "Lost " << lost << " vertical sync(s)");
+ }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class AdaptiveScheduler:                                                          *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+AdaptiveScheduler::AdaptiveScheduler(unsigned rate, unsigned max_divider):
+    FixedRateScheduler(rate),
+    myMaxDivider(max_divider ? max_divider : 1),
+    myDivider(1),
+    myWindowFrames(0),
+    myWindowMissed(0),
+    myWindowMaxWork(0)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+AdaptiveScheduler::~AdaptiveScheduler()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+void AdaptiveScheduler::Start(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ FixedRateScheduler::Start();
+
+ myDivider = 1;
+ myWindowFrames = 0;
+ myWindowMissed = myMissed;
+ myWindowMaxWork = 0;
+}
+
+void AdaptiveScheduler::WaitNextFrame(Glesly::Target &)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ // The time spent in the actual frame:
+ int64_t work = Clock::Now() - myDeadline;
+ if (work > myWindowMaxWork) {
+    myWindowMaxWork = work;
+ }
+
+ if (++myWindowFrames >= WINDOW_SIZE) {
+    unsigned long missed = myMissed - myWindowMissed;
+    if (missed > WINDOW_SIZE / 10 && myDivider < myMaxDivider) {
+        // More than 10% of the frames are late: slow down
+        ++myDivider;
+        SYS_DEBUG(DL_INFO1, "Frame rate decreased to " << GetFrameRate() / myDivider << " Hz");
+    } else if (missed == 0 && myDivider > 1 && myWindowMaxWork < myPeriod * (myDivider - 1) * 3 / 4) {
+        // All frames would have fit into the faster rate with some reserve: speed up
+        --myDivider;
+        SYS_DEBUG(DL_INFO1, "Frame rate increased to " << GetFrameRate() / myDivider << " Hz");
+    }
+    myWindowFrames = 0;
+    myWindowMissed = myMissed;
+    myWindowMaxWork = 0;
+ }
+
+ WaitDeadline(myPeriod * myDivider);
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
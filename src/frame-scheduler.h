@@ -0,0 +1,183 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Frame pacing of the Render Thread
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_FRAME_SCHEDULER_H_INCLUDED__
+#define __GLESLY_SRC_FRAME_SCHEDULER_H_INCLUDED__
+
+#include <glesly/config.h>
+#include <glesly/clock.h>
+#include <glesly/target.h>
+#include <glesly/frame-statistics.h>
+#include <Memory/Memory.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// Base class of the frame pacing strategies
+    /*! The function \ref FrameScheduler::WaitNextFrame() is called by the Render Thread after
+     *  each frame, and returns when the next frame can be started.<br>
+     *  The frame rate is given in Hz, see also \ref CONFIG_FRAME_RATE for the default value. */
+    class FrameScheduler
+    {
+     public:
+        virtual ~FrameScheduler();
+
+        /// Called once before the first frame
+        virtual void Start(void);
+
+        /// Waits for the start of the next frame
+        virtual void WaitNextFrame(Glesly::Target & target) =0;
+
+        /// Called when the frame loop continues after an idle period
+        /*! The frames skipped while idle are not counted as missed. */
+        virtual void Resume(void) { }
+
+        void SetFrameRate(unsigned rate);
+
+        inline unsigned GetFrameRate(void) const
+        {
+            return myRate;
+        }
+
+        /// The nominal frame time in nanoseconds
+        inline int64_t GetFramePeriod(void) const
+        {
+            return myPeriod;
+        }
+
+        /// The number of frames started since \ref FrameScheduler::Start()
+        inline unsigned long GetFrameCount(void) const
+        {
+            return myFrames;
+        }
+
+        /// The number of frame deadlines missed since \ref FrameScheduler::Start()
+        inline unsigned long GetMissedFrames(void) const
+        {
+            return myMissed;
+        }
+
+        /// How late the Render Thread wakes up after the frame sleep
+        /*! It is measured only by the schedulers sleeping until a known deadline. A high value
+         *  means that the Render Thread had to wait for a CPU, see \ref Main::SetRenderThreadPolicy(). */
+        inline const Glesly::RollingStatistics & GetWakeupLatency(void) const
+        {
+            return myWakeupLatency;
+        }
+
+     protected:
+        FrameScheduler(unsigned rate);
+
+        Glesly::RollingStatistics myWakeupLatency;
+
+        int64_t myPeriod;
+
+        unsigned long myFrames;
+
+        unsigned long myMissed;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::FrameScheduler");
+
+        unsigned myRate;
+
+    }; // class FrameScheduler
+
+    typedef MEM::shared_ptr<FrameScheduler> FrameSchedulerPtr;
+
+    /// Fixed frame rate, based on absolute deadlines
+    /*! The deadline of the next frame is always calculated from the previous deadline, so the
+     *  frame rate does not drift. If a frame runs late, the missed periods are skipped and
+     *  counted, but the phase of the frames is kept. */
+    class FixedRateScheduler: public FrameScheduler
+    {
+     public:
+        FixedRateScheduler(unsigned rate = CONFIG_FRAME_RATE);
+        virtual ~FixedRateScheduler();
+
+        virtual void Start(void) override;
+        virtual void WaitNextFrame(Glesly::Target & target) override;
+        virtual void Resume(void) override;
+
+     protected:
+        void WaitDeadline(int64_t period);
+
+        /// The start time of the actual frame
+        int64_t myDeadline;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::FixedRateScheduler");
+
+    }; // class FixedRateScheduler
+
+    /// Frame pacing by the vertical sync of the target
+    /*! The function \ref Target::Wait4Sync() is used to wait for the next frame. The frame rate
+     *  is the expected refresh rate of the display, it is used only to count the missed frames. */
+    class VsyncScheduler: public FrameScheduler
+    {
+     public:
+        VsyncScheduler(unsigned rate = CONFIG_FRAME_RATE);
+        virtual ~VsyncScheduler();
+
+        virtual void Start(void) override;
+        virtual void WaitNextFrame(Glesly::Target & target) override;
+        virtual void Resume(void) override;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::VsyncScheduler");
+
+        int64_t myPrevious;
+
+    }; // class VsyncScheduler
+
+    /// Fixed frame rate with automatic fallback
+    /*! If the frames cannot be finished in time, the frame rate is divided by an integer value
+     *  (e.g. 120 -> 60 -> 40 -> 30 Hz), and it is restored when the frames become fast enough
+     *  again. The decisions are made on windows of frames, to prevent oscillation. */
+    class AdaptiveScheduler: public FixedRateScheduler
+    {
+     public:
+        AdaptiveScheduler(unsigned rate = CONFIG_FRAME_RATE, unsigned max_divider = 4);
+        virtual ~AdaptiveScheduler();
+
+        virtual void Start(void) override;
+        virtual void WaitNextFrame(Glesly::Target & target) override;
+
+        /// The actual divider of the nominal frame rate
+        inline unsigned GetDivider(void) const
+        {
+            return myDivider;
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::AdaptiveScheduler");
+
+        /// The number of frames in one decision window
+        static constexpr unsigned WINDOW_SIZE = 60;
+
+        unsigned myMaxDivider;
+
+        unsigned myDivider;
+
+        unsigned myWindowFrames;
+
+        unsigned long myWindowMissed;
+
+        int64_t myWindowMaxWork;
+
+    }; // class AdaptiveScheduler
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_FRAME_SCHEDULER_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
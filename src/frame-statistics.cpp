@@ -0,0 +1,141 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Timing statistics of the frame phases
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "frame-statistics.h"
+
+#include <algorithm>
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class RollingStatistics:                                                          *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+RollingStatistics::RollingStatistics(void):
+    myCount(0),
+    myNext(0)
+{
+}
+
+void RollingStatistics::Add(int64_t value)
+{
+ Threads::Lock _l(myMutex);
+
+ mySamples[myNext] = value;
+ myNext = (myNext + 1) % WINDOW_SIZE;
+ if (myCount < WINDOW_SIZE) {
+    ++myCount;
+ }
+}
+
+void RollingStatistics::Reset(void)
+{
+ Threads::Lock _l(myMutex);
+
+ myCount = 0;
+ myNext = 0;
+}
+
+unsigned RollingStatistics::GetSamples(void) const
+{
+ Threads::Lock _l(myMutex);
+
+ return myCount;
+}
+
+/// Calculates a percentile of the samples in the window
+/*! \param  percent The requested percentile, e.g. 50 for the median.
+ *  \retval The value in nanoseconds, or 0 if there are no samples yet. */
+int64_t RollingStatistics::GetPercentile(unsigned percent) const
+{
+ int64_t samples[WINDOW_SIZE];
+ unsigned count;
+
+ {
+    Threads::Lock _l(myMutex);
+    count = myCount;
+    std::copy(mySamples, mySamples + count, samples);
+ }
+
+ if (!count) {
+    return 0;
+ }
+
+ unsigned index = std::min(count - 1, (count * std::min(percent, 100U)) / 100U);
+
+ std::nth_element(samples, samples + index, samples + count);
+
+ return samples[index];
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class FrameStatistics:                                                            *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+void FrameStatistics::Reset(void)
+{
+ for (int i = 0; i < PHASE_MAX; ++i) {
+    myPhases[i].Reset();
+ }
+}
+
+const char * FrameStatistics::GetPhaseName(Phase phase)
+{
+ switch (phase) {
+    case PHASE_CLEAR:
+        return "clear";
+    case PHASE_BEFORE_FRAME:
+        return "before-frame";
+    case PHASE_SETUP:
+        return "setup";
+    case PHASE_OBJECT_INIT:
+        return "object-init";
+    case PHASE_CALLBACKS:
+        return "callbacks";
+    case PHASE_DRAW:
+        return "draw";
+    case PHASE_AFTER_FRAME:
+        return "after-frame";
+    case PHASE_RENDER:
+        return "render";
+    case PHASE_TIMER_HANDOFF:
+        return "timer-handoff";
+    case PHASE_CAPTURE:
+        return "capture";
+    case PHASE_SWAP:
+        return "swap";
+    case PHASE_FRAME:
+        return "frame";
+    default:
+    break;
+ }
+ return "unknown";
+}
+
+/// Prints p50/p95/p99 of the measured phases, in microseconds
+void FrameStatistics::toStream(std::ostream & os) const
+{
+ for (int i = 0; i < PHASE_MAX; ++i) {
+    const RollingStatistics & phase = myPhases[i];
+    if (!phase.GetSamples()) {
+        continue;
+    }
+    os << GetPhaseName((Phase)i) << ": "
+       << phase.GetPercentile(50) / Clock::NSEC_PER_USEC << "/"
+       << phase.GetPercentile(95) / Clock::NSEC_PER_USEC << "/"
+       << phase.GetPercentile(99) / Clock::NSEC_PER_USEC << " us; ";
+ }
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
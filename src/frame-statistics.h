@@ -0,0 +1,162 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Timing statistics of the frame phases
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_FRAME_STATISTICS_H_INCLUDED__
+#define __GLESLY_SRC_FRAME_STATISTICS_H_INCLUDED__
+
+#include <iostream>
+
+#include <glesly/clock.h>
+#include <Threads/Mutex.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// Rolling window of time samples
+    /*! It keeps the last \ref RollingStatistics::WINDOW_SIZE samples, and calculates percentiles
+     *  on demand. The samples are added by one thread (typically the Render Thread), and can be
+     *  queried from any thread. All values are in nanoseconds. */
+    class RollingStatistics
+    {
+     public:
+        RollingStatistics(void);
+
+        void Add(int64_t value);
+        void Reset(void);
+        int64_t GetPercentile(unsigned percent) const;
+        unsigned GetSamples(void) const;
+
+        static constexpr unsigned WINDOW_SIZE = 128;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::RollingStatistics");
+
+        int64_t mySamples[WINDOW_SIZE];
+
+        unsigned myCount;
+
+        unsigned myNext;
+
+        mutable Threads::Mutex myMutex;
+
+    }; // class RollingStatistics
+
+    /// Time spent in the phases of the frames
+    /*! The phases are measured one after the other: \ref FrameStatistics::Start() must be called at
+     *  the beginning of the frame, then \ref FrameStatistics::Mark() at the end of each phase. The
+     *  time since the previous mark is accounted to the given phase. */
+    class FrameStatistics
+    {
+     public:
+        enum Phase
+        {
+            /// \ref Main::Clear()
+            PHASE_CLEAR     = 0,
+
+            /// \ref Render::BeforeFrame()
+            PHASE_BEFORE_FRAME,
+
+            /// Program activation and \ref Render::Frame()
+            PHASE_SETUP,
+
+            /// Executing \ref ObjectBase::initGL() of the new objects
+            PHASE_OBJECT_INIT,
+
+            /// Executing the callbacks of the objects, see \ref ObjectBase::Execute()
+            PHASE_CALLBACKS,
+
+            /// Drawing the objects
+            PHASE_DRAW,
+
+            /// \ref Render::AfterFrame()
+            PHASE_AFTER_FRAME,
+
+            /// All the Renders, measured in \ref Main::Run()
+            PHASE_RENDER,
+
+            /// Triggering the Timer Thread
+            PHASE_TIMER_HANDOFF,
+
+            /// \ref FrameCapture::Capture()
+            PHASE_CAPTURE,
+
+            /// \ref Backend::SwapBuffers()
+            PHASE_SWAP,
+
+            /// The whole frame, from \ref FrameStatistics::Start()
+            PHASE_FRAME,
+
+            PHASE_MAX
+
+        }; // enum Glesly::FrameStatistics::Phase
+
+        inline FrameStatistics(void):
+            myStart(0),
+            myLast(0)
+        {
+        }
+
+        inline void Start(void)
+        {
+            myStart = myLast = Clock::Now();
+        }
+
+        inline void Mark(Phase phase)
+        {
+            int64_t now = Clock::Now();
+            myPhases[phase].Add(now - myLast);
+            myLast = now;
+        }
+
+        inline void Finish(void)
+        {
+            myLast = Clock::Now();
+            myPhases[PHASE_FRAME].Add(myLast - myStart);
+        }
+
+        inline const RollingStatistics & operator[](Phase phase) const
+        {
+            return myPhases[phase];
+        }
+
+        inline int64_t GetPercentile(Phase phase, unsigned percent) const
+        {
+            return myPhases[phase].GetPercentile(percent);
+        }
+
+        void Reset(void);
+        void toStream(std::ostream & os) const;
+
+        static const char * GetPhaseName(Phase phase);
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::FrameStatistics");
+
+        int64_t myStart;
+
+        int64_t myLast;
+
+        RollingStatistics myPhases[PHASE_MAX];
+
+    }; // class FrameStatistics
+
+} // namespace Glesly
+
+static inline std::ostream & operator<<(std::ostream & os, const Glesly::FrameStatistics & stat)
+{
+ stat.toStream(os);
+ return os;
+}
+
+#endif /* __GLESLY_SRC_FRAME_STATISTICS_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
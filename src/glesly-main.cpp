@@ -15,8 +15,6 @@
 
 #include <GLES2/gl2.h>
 
-#include <unistd.h>
-
 using namespace Glesly;
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
@@ -26,7 +24,17 @@ using namespace Glesly;
 \* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 Main::Main(void):
-    myTimer(new TimerThread(*this))
+    myTimer(new TimerThread(*this)),
+    myScheduler(new FixedRateScheduler),
+    mySimulationPeriod(0),
+    isRenderOnDemand(false),
+    isPartialRedraw(false),
+    wasPartialRedraw(false),
+    isRenderPolicyChanged(false),
+    isTimerPolicyChanged(false),
+    myTimerTriggerTime(0),
+    myFrameAllocations(0),
+    myWarmupFrames(0)
 {
  GetBackend().RegisterParent(this);
  myTimer->Start(myTimer, 4*65536);
@@ -34,7 +42,17 @@ Main::Main(void):
 
 Main::Main(TargetPtr & target):
     myTimer(new TimerThread(*this)),
-    myBackend(target)
+    myBackend(target),
+    myScheduler(new FixedRateScheduler),
+    mySimulationPeriod(0),
+    isRenderOnDemand(false),
+    isPartialRedraw(false),
+    wasPartialRedraw(false),
+    isRenderPolicyChanged(false),
+    isTimerPolicyChanged(false),
+    myTimerTriggerTime(0),
+    myFrameAllocations(0),
+    myWarmupFrames(0)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
@@ -72,8 +90,12 @@ void Main::Run(void)
     (*i)->Initialize();
  }
 
+ myScheduler->Start();
+
  myFrameStartTime.SetNow();
 
+ AllocationStats::Scope allocations(AllocationStats::SUBSYSTEM_RENDER);
+
  while (!ToBeFinished()) {
     Glesly::TargetPtr target = GetBackend().GetTarget();
 
@@ -81,12 +103,54 @@ void Main::Run(void)
         goto finished;
     }
 
+    ApplyThreadPolicy(myRenderPolicy, isRenderPolicyChanged);
+
+    // Release the Objects removed meanwhile, the readers do not do it:
+    ObjectStore::ReclaimAll();
+
+    if (isRenderOnDemand && !Redraw::Take()) {
+        // Nothing has been changed: wait for a request
+        do {
+            Redraw::Wait();
+            if (ToBeFinished()) {
+                goto finished;
+            }
+        } while (!Redraw::Take());
+        myScheduler->Resume();
+        myFrameStartTime.SetNow();
+    }
+
+    DamageRect damage(0, 0, target->GetWidth(), target->GetHeight());
+
+    if (!SetRedrawArea(damage)) {
+        // Nothing to be redrawn: just trigger the timers
+        TriggerTimer();
+        myScheduler->WaitNextFrame(*target);
+        myFrameStartTime.SetNow();
+        continue;
+    }
+
     SYS_DEBUG(DL_INFO3, "Starting Frame...");
 
+    int64_t frame_start = Clock::Now();
+
+    uint64_t frame_allocations = AllocationStats::GetCount(AllocationStats::SUBSYSTEM_RENDER);
+
+    myStatistics.Start();
+
+    if (myScaler) {
+        if (!myScaler->IsInitialized(target->GetWidth(), target->GetHeight())) {
+            myScaler->InitGL(target->GetWidth(), target->GetHeight());
+        }
+        myScaler->Begin();
+    }
+
     glClearColor(0.3, 0.5, 0.7, 1.0);
 
     Clear();
 
+    myStatistics.Mark(FrameStatistics::PHASE_CLEAR);
+
     for (RenderList::iterator i = myRenders.begin(); i != myRenders.end(); ++i) {
         if (ToBeFinished()) {
             goto finished;
@@ -94,30 +158,45 @@ void Main::Run(void)
         (*i)->NextFrame(myFrameStartTime);
     }
 
-    timerSemaphore.Post();
+    glDisable(GL_SCISSOR_TEST);
 
-    GetBackend().SwapBuffers();
+    if (myScaler) {
+        myScaler->End();
+        // Wait for the GPU, the fill rate is the bottleneck on the weak boards. The swap is not
+        // counted, a blocking swap would take the whole period:
+        glFinish();
+    }
 
-    {
-        SYS::TimeDelay now;
-        now.SetNow();
+    myStatistics.Mark(FrameStatistics::PHASE_RENDER);
 
-        int elapsed = (now - myFrameStartTime).ToMicrosecond();
+    int64_t render_time = Clock::Now() - frame_start;
 
-        static constexpr int FRAME_DELAY_USEC = 1000000 / 60;
+    TriggerTimer();
 
-        // Calculate the time to wait to fill the actual frame time to the expected value:
-        int time_diff = FRAME_DELAY_USEC - elapsed;
+    myStatistics.Mark(FrameStatistics::PHASE_TIMER_HANDOFF);
 
-        if (time_diff > 2000) {
-            // We must wait more than 2 ms:
-            myFrameStartTime.AddMicrosecond(FRAME_DELAY_USEC);
-            usleep(time_diff);
-        } else {
-            // Not necessary to wait:
-            myFrameStartTime = now;
-        }
+    FrameCapturePtr capture = myCapture;
+    if (capture) {
+        capture->Capture();
+        myStatistics.Mark(FrameStatistics::PHASE_CAPTURE);
+    }
+
+    GetBackend().SwapBuffers(isPartialRedraw && !myScaler ? &damage : NULL);
+
+    myStatistics.Mark(FrameStatistics::PHASE_SWAP);
+    myStatistics.Finish();
+
+    if (myScaler) {
+        myScaler->Update(render_time, myScheduler->GetFramePeriod());
     }
+
+    if (AllocationStats::IsEnabled()) {
+        CheckFrameAllocations(AllocationStats::GetCount(AllocationStats::SUBSYSTEM_RENDER) - frame_allocations);
+    }
+
+    myScheduler->WaitNextFrame(*target);
+
+    myFrameStartTime.SetNow();
  }
 
 finished:;
@@ -129,9 +208,78 @@ finished:;
     (*i)->ProgramCleanup();
  }
 
+ if (myScaler) {
+    myScaler->CleanupGL();
+ }
+
  Cleanup();
 }
 
+/// Calculates the area to be redrawn in the actual frame
+/*! If the partial redraw is switched on, the scissor test is set to the area to be redrawn, and
+ *  the Renders are notified not to draw the objects out of it.
+ *  \param  damage  It must be the whole screen on input. On output, it is the area changed since
+ *                  the previous frame.
+ *  \retval false   Nothing has been changed, the frame can be skipped. */
+bool Main::SetRedrawArea(DamageRect & damage)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ DamageRect full(damage);
+ DamageRect area;
+
+ if (isPartialRedraw && !myScaler) {
+    if (!wasPartialRedraw) {
+        // The history is not valid:
+        myDamageHistory.Reset(full);
+        wasPartialRedraw = true;
+    }
+    damage = Redraw::TakeDamage(full);
+    if (damage.IsEmpty()) {
+        return false;
+    }
+    area = myDamageHistory.GetRepaintArea(damage, GetBackend().QueryBufferAge(), full);
+    myDamageHistory.Push(damage);
+    SYS_DEBUG(DL_INFO3, "Redraw area: " << area.x << "," << area.y << " " << area.width << "x" << area.height);
+    if (area.Covers(full)) {
+        area = DamageRect();
+    } else {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(area.x, area.y, area.width, area.height);
+    }
+ } else {
+    wasPartialRedraw = false;
+ }
+
+ for (RenderList::iterator i = myRenders.begin(); i != myRenders.end(); ++i) {
+    (*i)->SetRedrawArea(area);
+ }
+
+ return true;
+}
+
+/// Applies the policy to the calling thread if it has been changed
+/*! \param  policy  The policy of the calling thread.
+ *  \param  changed It is set when the policy is changed. */
+void Main::ApplyThreadPolicy(const ThreadPolicy & policy, std::atomic<bool> & changed)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!changed.load(std::memory_order_relaxed)) {
+    return;
+ }
+
+ ThreadPolicy copy;
+
+ {
+    Threads::Lock _l(myPolicyMutex);
+    changed = false;
+    copy = policy;
+ }
+
+ copy.Apply();
+}
+
 void Main::MouseClick(int x, int y, int index, int count)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
@@ -141,13 +289,39 @@ void Main::MouseClick(int x, int y, int index, int count)
  }
 }
 
+/// Reports the heap allocations of a frame in the steady state
+/*! \param  count   The number of allocations in the last frame.
+ *  \see Main::GetFrameAllocations() */
+void Main::CheckFrameAllocations(uint64_t count)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myFrameAllocations = count;
+
+ if (myWarmupFrames < ALLOCATION_WARMUP_FRAMES) {
+    ++myWarmupFrames;
+    return;
+ }
+
+ if (count) {
+    DEBUG_OUT("WARNING: " << count << " heap allocations in a steady frame");
+ }
+}
+
 void Main::Clear(void)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
  SYS_DEBUG(DL_INFO3, " - glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);");
 
- Threads::LockPtr _l = GetGraphicalLock();
+ Glesly::TargetPtr target = GetBackend().GetTarget();
+
+ if (!target) {
+    return;
+ }
+
+ // Note: a scoped lock here, not GetGraphicalLock(), to avoid the allocation in each frame
+ Threads::Lock _l(target->GetGraphicMutex());
 
  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
  if (eglGetError() != EGL_SUCCESS) {
@@ -163,7 +337,9 @@ void Main::Clear(void)
 
 Main::TimerThread::TimerThread(Main & parent):
     Threads::Thread("TimerThread"),
-    myParent(parent)
+    myParent(parent),
+    myLastStep(0),
+    myAccumulator(0)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 }
@@ -178,26 +354,97 @@ int Main::TimerThread::main(void)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
- Main::RenderList & renders = myParent.getRenderers();
  Threads::Semaphore & semaphore = myParent.getTimerSemaphore();
 
  while (!ToBeFinished()) {
     // Wait for trigger from render thread first:
     semaphore.Wait();
 
-    //
-    myParent.RenderTimer();
+    myParent.myTimerWakeupLatency.Add(Clock::Now() - myParent.myTimerTriggerTime.load(std::memory_order_relaxed));
 
-    // Call timer functions:
-    for (RenderList::iterator i = renders.begin(); i != renders.end(); ++i) {
-        if (ToBeFinished()) {
-            return 0;
+    myParent.ApplyThreadPolicy(myParent.myTimerPolicy, myParent.isTimerPolicyChanged);
+
+    int64_t period = myParent.mySimulationPeriod;
+
+    if (period) {
+        FixedSteps(period);
+    } else {
+        if (myLastStep) {
+            // Switched back to one step per frame: no interpolation any more
+            Main::RenderList & renders = myParent.getRenderers();
+            for (RenderList::iterator i = renders.begin(); i != renders.end(); ++i) {
+                (*i)->SetInterpolation(1.0f);
+            }
+            myLastStep = 0;
         }
-        (*i)->Timer();
+        Step();
     }
  }
 
  return 0;
 }
 
+/// Calls the timer functions once
+void Main::TimerThread::Step(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ AllocationStats::Scope allocations(AllocationStats::SUBSYSTEM_TIMER);
+
+ Main::RenderList & renders = myParent.getRenderers();
+
+ myParent.RenderTimer();
+
+ // Call timer functions:
+ for (RenderList::iterator i = renders.begin(); i != renders.end(); ++i) {
+    if (ToBeFinished()) {
+        return;
+    }
+    (*i)->Timer();
+ }
+}
+
+/// Calls the timer functions for each simulation step elapsed since the previous frame
+/*! \param  period  The time of one simulation step in nanoseconds.
+ *  \see Main::SetSimulationRate() */
+void Main::TimerThread::FixedSteps(int64_t period)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ int64_t now = Clock::Now();
+
+ if (!myLastStep) {
+    // The first frame: start with one step
+    myLastStep = now;
+    myAccumulator = period;
+ } else {
+    myAccumulator += now - myLastStep;
+    myLastStep = now;
+ }
+
+ unsigned steps = myAccumulator / period;
+
+ if (steps > MAX_SIMULATION_STEPS) {
+    SYS_DEBUG(DL_INFO2, "Simulation is late, dropping " << (steps - MAX_SIMULATION_STEPS) << " steps");
+    steps = MAX_SIMULATION_STEPS;
+    myAccumulator = steps * period;
+ }
+
+ myAccumulator -= steps * period;
+
+ while (steps--) {
+    if (ToBeFinished()) {
+        return;
+    }
+    Step();
+ }
+
+ float alpha = (float)myAccumulator / (float)period;
+
+ Main::RenderList & renders = myParent.getRenderers();
+ for (RenderList::iterator i = renders.begin(); i != renders.end(); ++i) {
+    (*i)->SetInterpolation(alpha);
+ }
+}
+
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
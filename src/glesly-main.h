@@ -12,6 +12,7 @@
 #define __GLESLY_SRC_GLESLY_MAIN_H_INCLUDED__
 
 #include <list>
+#include <atomic>
 #include <GLES2/gl2.h>
 
 #include <Threads/Threads.h>
@@ -19,6 +20,12 @@
 #include <glesly/backend.h>
 #include <glesly/render.h>
 #include <glesly/camera.h>
+#include <glesly/frame-scheduler.h>
+#include <glesly/frame-capture.h>
+#include <glesly/resolution-scaler.h>
+#include <glesly/thread-policy.h>
+#include <glesly/redraw.h>
+#include <glesly/allocation-stats.h>
 
 SYS_DECLARE_MODULE(DM_GLESLY);
 
@@ -87,6 +94,140 @@ namespace Glesly
             return GetBackend().GetGraphicalLock();
         }
 
+        /// Replaces the frame pacing strategy
+        /*! The default is a \ref FixedRateScheduler with \ref CONFIG_FRAME_RATE frames per second.
+         *  \note   It must be called before \ref Main::Run(). */
+        inline void SetFrameScheduler(FrameSchedulerPtr scheduler)
+        {
+            ASSERT(scheduler, "frame scheduler is not given");
+            myScheduler = scheduler;
+        }
+
+        inline Glesly::FrameScheduler & GetFrameScheduler(void)
+        {
+            return *myScheduler;
+        }
+
+        /// Draws the frames only when something has been changed
+        /*! If it is switched on, the frame loop blocks until \ref Redraw::Request() is called.
+         *  The Timer Thread is not triggered while the loop is blocked, so the objects animated
+         *  by \ref ObjectBase::Timer() must change something (e.g. a transformation) in each step
+         *  to keep the animation running.
+         *  \note   If \ref Main::ToBeFinished() may become true without a close request from the
+         *          target, \ref Redraw::Request() must be called to finish the loop. */
+        inline void SetRenderOnDemand(bool on_demand = true)
+        {
+            isRenderOnDemand = on_demand;
+            Redraw::Request();
+        }
+
+        inline bool IsRenderOnDemand(void) const
+        {
+            return isRenderOnDemand;
+        }
+
+        /// Redraws only the changed area of the screen
+        /*! The changed area is collected by \ref Redraw, and the objects with known bounds are
+         *  drawn only if they are in this area, see \ref ObjectBase::SetScreenBounds().<br>
+         *  It is effective only if the back buffer age can be queried (EGL_EXT_buffer_age), the
+         *  whole screen is redrawn otherwise. */
+        inline void SetPartialRedraw(bool partial = true)
+        {
+            isPartialRedraw = partial;
+            Redraw::Request();
+        }
+
+        /// Captures the frames into files
+        /*! \param  capture The capture object, or an empty pointer to stop capturing.
+         *  \note   The size of the capture should be the size of the target. */
+        inline void SetFrameCapture(FrameCapturePtr capture)
+        {
+            myCapture = capture;
+        }
+
+        inline FrameCapturePtr GetFrameCapture(void) const
+        {
+            return myCapture;
+        }
+
+        /// Renders the frames in adaptive resolution
+        /*! \param  scaler  The scaler, or an empty pointer to render in full resolution.
+         *  \note   The partial redraw (\ref Main::SetPartialRedraw()) is not used while the scaler
+         *          is active, because the whole offscreen image is stretched in each frame.
+         *  \note   It must be called before \ref Main::Run(). */
+        inline void SetResolutionScaler(ResolutionScalerPtr scaler)
+        {
+            myScaler = scaler;
+        }
+
+        inline ResolutionScalerPtr GetResolutionScaler(void) const
+        {
+            return myScaler;
+        }
+
+        /// Runs the simulation in fixed time steps
+        /*! By default the Timer functions are called once after each frame, so the speed of the
+         *  animations depends on the frame rate. If a simulation rate is set, the Timer Thread
+         *  accumulates the real time, and calls the Timer functions once for each elapsed step
+         *  (at most \ref Main::MAX_SIMULATION_STEPS times per frame, the rest is dropped).<br>
+         *  The position of the frame between the last two steps is passed to the Renders by
+         *  \ref Render::SetInterpolation(), and the Object projections are blended accordingly.
+         *  \param  rate    The number of steps per second, or 0 to step once per frame. */
+        inline void SetSimulationRate(unsigned rate)
+        {
+            mySimulationPeriod = rate ? Clock::NSEC_PER_SEC / rate : 0;
+        }
+
+        /// The maximum number of simulation steps after one frame
+        /*! It prevents the spiral of death: if the steps are slower than the real time, the
+         *  simulation slows down instead of blocking the Timer Thread. */
+        static constexpr unsigned MAX_SIMULATION_STEPS = 5;
+
+        /// Sets the CPU affinity and scheduling of the Render Thread
+        /*! The Render Thread is the one calling \ref Main::Run(). The policy is applied at the
+         *  start of the next frame. */
+        inline void SetRenderThreadPolicy(const Glesly::ThreadPolicy & policy)
+        {
+            Threads::Lock _l(myPolicyMutex);
+            myRenderPolicy = policy;
+            isRenderPolicyChanged = true;
+        }
+
+        /// Sets the CPU affinity and scheduling of the Timer Thread
+        /*! The policy is applied when the Timer Thread is triggered next time. */
+        inline void SetTimerThreadPolicy(const Glesly::ThreadPolicy & policy)
+        {
+            Threads::Lock _l(myPolicyMutex);
+            myTimerPolicy = policy;
+            isTimerPolicyChanged = true;
+        }
+
+        /// How late the Timer Thread wakes up after it is triggered by the Render Thread
+        /*! \see FrameScheduler::GetWakeupLatency() for the Render Thread */
+        inline const Glesly::RollingStatistics & GetTimerWakeupLatency(void) const
+        {
+            return myTimerWakeupLatency;
+        }
+
+        /// The number of heap allocations in the last frame of the Render Thread
+        /*! It is counted only if \ref CONFIG_ALLOCATION_ACCOUNTING is set. After
+         *  \ref Main::ALLOCATION_WARMUP_FRAMES frames, the frames allocating on the heap are
+         *  reported, see \ref AllocationStats. */
+        inline uint64_t GetFrameAllocations(void) const
+        {
+            return myFrameAllocations;
+        }
+
+        /// The number of frames not checked for allocations, see \ref Main::GetFrameAllocations()
+        static constexpr unsigned ALLOCATION_WARMUP_FRAMES = 100;
+
+        /// Timing of the phases of the frame loop in \ref Main::Run()
+        /*! \see Render::GetStatistics() for the details of the individual Renders */
+        inline const Glesly::FrameStatistics & GetStatistics(void) const
+        {
+            return myStatistics;
+        }
+
      protected:
         Glesly::CameraMatrix myViewMatrix;
 
@@ -98,6 +239,7 @@ namespace Glesly
         /*! It is synchronized to the frame cycle of the OpenGL Render Thread.<br>
          *  All \ref ObjectBase::Timer() functions of the corresponding objects are also called.
          *  \note   If the timer functions are too slow, it is possible to lose the synchronization.
+         *          See \ref Render::SetTimerPool() to execute them in parallel.
          *  */
         virtual void RenderTimer(void) { }
 
@@ -110,11 +252,20 @@ namespace Glesly
          protected:
             virtual int main(void) override;
 
+            void Step(void);
+            void FixedSteps(int64_t period);
+
             Main & myParent;
 
          private:
             SYS_DEFINE_CLASS_NAME("Glesly::Main::TimerThread");
 
+            /// The time of the last simulation step, 0 if the fixed steps are not running
+            int64_t myLastStep;
+
+            /// The real time not simulated yet
+            int64_t myAccumulator;
+
         }; // class Glesly::Main::TimerThread
 
         Threads::Semaphore timerSemaphore;
@@ -124,10 +275,61 @@ namespace Glesly
      private:
         SYS_DEFINE_CLASS_NAME("Glesly::Main");
 
+        bool SetRedrawArea(Glesly::DamageRect & damage);
+        void ApplyThreadPolicy(const Glesly::ThreadPolicy & policy, std::atomic<bool> & changed);
+        void CheckFrameAllocations(uint64_t count);
+
+        /// Starts the Timer Thread
+        inline void TriggerTimer(void)
+        {
+            myTimerTriggerTime.store(Clock::Now(), std::memory_order_relaxed);
+            timerSemaphore.Post();
+        }
+
         Glesly::Backend myBackend;
 
         RenderList myRenders;
 
+        FrameSchedulerPtr myScheduler;
+
+        /// The time of one simulation step in nanoseconds, 0 to step once per frame
+        std::atomic<int64_t> mySimulationPeriod;
+
+        Glesly::FrameStatistics myStatistics;
+
+        FrameCapturePtr myCapture;
+
+        ResolutionScalerPtr myScaler;
+
+        bool isRenderOnDemand;
+
+        bool isPartialRedraw;
+
+        /// Used by the Render Thread to detect switching on the partial redraw
+        bool wasPartialRedraw;
+
+        Glesly::DamageHistory myDamageHistory;
+
+        Threads::Mutex myPolicyMutex;
+
+        Glesly::ThreadPolicy myRenderPolicy;
+
+        Glesly::ThreadPolicy myTimerPolicy;
+
+        std::atomic<bool> isRenderPolicyChanged;
+
+        std::atomic<bool> isTimerPolicyChanged;
+
+        /// The time of the last \ref Main::TriggerTimer()
+        std::atomic<int64_t> myTimerTriggerTime;
+
+        Glesly::RollingStatistics myTimerWakeupLatency;
+
+        uint64_t myFrameAllocations;
+
+        /// The number of frames drawn, up to \ref Main::ALLOCATION_WARMUP_FRAMES
+        unsigned myWarmupFrames;
+
     }; // class Main
 
 } // namespace Glesly
@@ -0,0 +1,144 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Offscreen Target without display
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "headless-target.h"
+
+#include <EGL/eglext.h>
+#include <string.h>
+
+#include <glesly/error.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA   0x31DD
+#endif
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *       class HeadlessTarget:                                                           *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+HeadlessTarget::HeadlessTarget(int width, int height):
+    myWidth(width),
+    myHeight(height),
+    isSurfaceless(false)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ASSERT(width > 0 && height > 0, "invalid headless target size: " << width << "x" << height);
+}
+
+HeadlessTarget::~HeadlessTarget()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+void HeadlessTarget::Initialize(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+EGLDisplay HeadlessTarget::GetEGLDisplay(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ // The client extensions are queried without display:
+ const char * extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+ if (extensions && strstr(extensions, "EGL_MESA_platform_surfaceless") && strstr(extensions, "EGL_EXT_platform_base")) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (display != EGL_NO_DISPLAY) {
+            SYS_DEBUG(DL_INFO1, "Using the surfaceless platform");
+            isSurfaceless = true;
+            return display;
+        }
+    }
+ }
+
+ SYS_DEBUG(DL_INFO1, "Using the default display");
+
+ isSurfaceless = false;
+
+ EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+ if (display == EGL_NO_DISPLAY) {
+    throw Error("Could not eglGetDisplay()");
+ }
+
+ return display;
+}
+
+/// Creates the pbuffer surface
+/*! The surface type is selected by \ref HeadlessTarget::GetEGLConfigAttribs(), so the 'config'
+ *  is suitable for pbuffers. */
+EGLSurface HeadlessTarget::CreateWindowSurface(EGLDisplay display, EGLConfig config)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ EGLint attribs[] = {
+    EGL_WIDTH,      myWidth,
+    EGL_HEIGHT,     myHeight,
+    EGL_NONE
+ };
+
+ EGLSurface surface = eglCreatePbufferSurface(display, config, attribs);
+ if (surface == EGL_NO_SURFACE) {
+    throw Error("Could not eglCreatePbufferSurface()");
+ }
+
+ SYS_DEBUG(DL_INFO1, "Created pbuffer: " << myWidth << "x" << myHeight);
+
+ return surface;
+}
+
+/// RGBA8888 pbuffer configuration with 16-bit depth buffer
+const EGLint * HeadlessTarget::GetEGLConfigAttribs(void) const
+{
+ static const EGLint attribs[] = {
+    EGL_SURFACE_TYPE,       EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE,    EGL_OPENGL_ES2_BIT,
+    EGL_RED_SIZE,           8,
+    EGL_GREEN_SIZE,         8,
+    EGL_BLUE_SIZE,          8,
+    EGL_ALPHA_SIZE,         8,
+    EGL_DEPTH_SIZE,         16,
+    EGL_NONE
+ };
+
+ return attribs;
+}
+
+/// There are no events to be handled
+/*! This function just waits until \ref HeadlessTarget::Close() is called. */
+bool HeadlessTarget::EnterEventLoop(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myClosed.Wait();
+
+ return true;
+}
+
+/// Finishes the rendering
+/*! The frame loop is notified via \ref TargetHolder::CloseRequest(), and the function
+ *  \ref HeadlessTarget::EnterEventLoop() returns. */
+void HeadlessTarget::Close(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ CloseRequest();
+
+ myClosed.Post();
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
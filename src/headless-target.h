@@ -0,0 +1,74 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Offscreen Target without display
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_HEADLESS_TARGET_H_INCLUDED__
+#define __GLESLY_SRC_HEADLESS_TARGET_H_INCLUDED__
+
+#include <glesly/target.h>
+#include <Threads/Semaphore.h>
+
+namespace Glesly
+{
+    /// Target rendering into an EGL pbuffer
+    /*! It can be used on machines without display or GPU (e.g. with Mesa llvmpipe), to render
+     *  images in batch or to measure the performance.<br>
+     *  If the EGL implementation supports the extension EGL_MESA_platform_surfaceless, it is
+     *  used to get the display, so neither X11 nor Wayland is necessary. Otherwise the default
+     *  display is used.
+     *  \note   There is no vertical sync, so the frames are paced by the \ref FrameScheduler
+     *          only. */
+    class HeadlessTarget: public Glesly::Target
+    {
+     public:
+        HeadlessTarget(int width, int height);
+        virtual ~HeadlessTarget();
+
+        virtual void Initialize(void) override;
+        virtual EGLDisplay GetEGLDisplay(void) override;
+        virtual EGLSurface CreateWindowSurface(EGLDisplay display, EGLConfig config) override;
+        virtual bool EnterEventLoop(void) override;
+        virtual const EGLint * GetEGLConfigAttribs(void) const override;
+
+        virtual int GetWidth(void) const override
+        {
+            return myWidth;
+        }
+
+        virtual int GetHeight(void) const override
+        {
+            return myHeight;
+        }
+
+        void Close(void);
+
+        /// Tells if the surfaceless platform is used
+        inline bool IsSurfaceless(void) const
+        {
+            return isSurfaceless;
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::HeadlessTarget");
+
+        int myWidth;
+
+        int myHeight;
+
+        bool isSurfaceless;
+
+        Threads::Semaphore myClosed;
+
+    }; // class HeadlessTarget
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_HEADLESS_TARGET_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -19,17 +19,48 @@ using namespace Glesly;
 ObjectBase::ObjectBase(Glesly::ObjectListBase & base):
     myBase(base),
     myEnabled(true),
-    myCallbackTimeLimit(0),
-    toBeDeleted(false)
+    toBeDeleted(false),
+    myRetireNext(nullptr),
+    myStore(nullptr),
+    myCommitPass(0),
+    isStateDirty(false),
+    myDirtyNext(nullptr),
+    myGLRequests(0),
+    isEvicted(false),
+    isGLInitialized(false),
+    myTimerGeneration(0),
+    myTimerPeriod(TIMER_OFF),
+    isTimerOnce(false),
+    myScreenBounds(0)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
- myCallbackTimeLimit = GetCallbackTimeLimit();
+ for (int i = 0; i < CALLBACK_PRIORITIES; ++i) {
+    myNewCallbacks[i] = nullptr;
+    isCallbackScheduled[i] = false;
+    myCallbacks[i] = nullptr;
+    myCallbackNext[i] = nullptr;
+ }
 }
 
 ObjectBase::~ObjectBase()
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ for (int i = 0; i < CALLBACK_PRIORITIES; ++i) {
+    CallbackRequest * request = myNewCallbacks[i].exchange(nullptr);
+    while (request) {
+        CallbackRequest * next = request->next;
+        delete request;
+        request = next;
+    }
+    request = myCallbacks[i];
+    while (request) {
+        CallbackRequest * next = request->next;
+        delete request;
+        request = next;
+    }
+ }
 }
 
 /// Call this function to (re)initialize the OpenGL functionality
@@ -38,42 +69,213 @@ ObjectBase::~ObjectBase()
  *          done at the next frame. */
 void ObjectBase::ReinitGL(void)
 {
+ myGLRequests.fetch_add(1, std::memory_order_relaxed);
  GetRenderer().InitGLObject(mySelf);
 }
 
-/// Calls \ref Glesly::ObjectBase::ObjectCallback::Execute() on demand
-void ObjectBase::ExecuteCallback(const SYS::TimeDelay & frame_start_time)
+void ObjectBase::UnuseGL(void)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
- // TODO Lock?
- if (myCallbacks.empty()) {
+ if (toBeDeleted.exchange(true)) {
     return;
  }
 
- SYS::TimeElapsed elapsed(frame_start_time);
- SYS_DEBUG(DL_INFO2, "Time from frame start: " << elapsed.ToMillisecond() << " ms");
-
- // Note: in debug mode, this time can be significantly longer, so ignore it instead:
- if (!SYS_DEBUG_ON) {
-    if (elapsed.ToMillisecond() > myCallbackTimeLimit) {
-        myCallbackTimeLimit += 1 + myCallbackTimeLimit / 8; // Exponential increase
-        return;
+ if (GetStore()) {
+    // The writers of the store are serialized by the mutex of the base, even for the layers:
+    Threads::Lock _l(myBase.GetObjectMutex());
+    Glesly::ObjectStore * store = GetStore();
+    if (store) {
+        store->Remove(this);
+        store->Publish();
     }
-    myCallbackTimeLimit = GetCallbackTimeLimit();
  }
 
- for (std::list<ObjectCallbackPtr>::iterator i = myCallbacks.begin(); i != myCallbacks.end(); ) {
-    std::list<ObjectCallbackPtr>::iterator obj = i++;
-    if ((*obj)->Execute(*this)) {
-        myCallbacks.erase(obj);
+ // The readers started from now on do not see it, so the GL resources can be released:
+ GetRenderer().Retire(*this);
+
+ Damage();
+}
+
+void ObjectBase::EvictGL(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (isEvicted || !CanEvictGL()) {
+    return;
+ }
+
+ isGLInitialized = false;
+ uninitGL();
+ isEvicted = true;
+}
+
+void ObjectBase::RestoreGL(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!isEvicted) {
+    return;
+ }
+
+ isEvicted = false;
+
+ // Re-initialized by the user meanwhile:
+ if (myGLRequests.load(std::memory_order_acquire)) {
+    return;
+ }
+
+ ReinitGL();
+}
+
+void ObjectBase::CommitFrameStates(Glesly::Render & render)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ render.CommitObject(*this);
+}
+
+/// Registers the timer of the object (any thread)
+/*! In \ref Render::TIMER_MODE_REGISTERED, the function \ref ObjectBase::Timer() is called only
+ *  if the object has registered its timer. The previous registration is replaced.
+ *  \param  period  The period in nanoseconds, e.g. Clock::NSEC_PER_SEC / 10 for 10 Hz.
+ *                  \ref ObjectBase::TIMER_EVERY_FRAME calls the timer after each frame,
+ *                  \ref ObjectBase::TIMER_OFF cancels it.
+ *  \note   The resolution of the periodic timers is \ref TimerWheel::TICK. */
+void ObjectBase::SetTimerPeriod(int64_t period)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ RegisterTimer(period, false);
+}
+
+/// Calls the timer of the object once, after the given delay (any thread)
+/*! \see ObjectBase::SetTimerPeriod() */
+void ObjectBase::SetTimerOnce(int64_t delay)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ RegisterTimer(delay, true);
+}
+
+void ObjectBase::RegisterTimer(int64_t period, bool once)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myTimerPeriod = period;
+ isTimerOnce = once;
+
+ // The registrations in the Render having older generations are dropped:
+ uint32_t generation = ++myTimerGeneration;
+
+ if (period == TIMER_OFF || mySelf.expired()) {
+    // Cancelled, or called from the constructor, see ObjectBase::Create()
+    return;
+ }
+
+ GetRenderer().RegisterTimer(mySelf, generation, period, once);
+}
+
+/// Adds a callback to be executed by the Render Thread (any thread)
+/*! The callback is executed before drawing a frame, in the callback phase of the Render. The
+ *  callbacks of all objects share a common time budget, see \ref Render::SetCallbackBudget(),
+ *  so the callbacks may be delayed to the next frames.
+ *  \param  callback    The callback to execute, see \ref ObjectCallback::Execute().
+ *  \param  priority    The high priority callbacks of all objects are executed before the
+ *                      normal ones. */
+void ObjectBase::Execute(ObjectCallbackPtr callback, CallbackPriority priority)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ CallbackRequest * request = new CallbackRequest;
+ request->callback = callback;
+
+ CallbackRequest * head = myNewCallbacks[priority].load(std::memory_order_relaxed);
+ do {
+    request->next = head;
+ } while (!myNewCallbacks[priority].compare_exchange_weak(head, request, std::memory_order_release, std::memory_order_relaxed));
+
+ ScheduleCallbacks(priority);
+}
+
+/// Puts the object into the callback queue of the Render, if it is not there yet
+void ObjectBase::ScheduleCallbacks(CallbackPriority priority)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (mySelf.expired()) {
+    // Called from the constructor, see ObjectBase::Create()
+    return;
+ }
+
+ if (!isCallbackScheduled[priority].exchange(true)) {
+    GetRenderer().ScheduleCallbacks(*this, priority);
+ }
+
+ Redraw::Request();
+}
+
+/// Schedules the pending callbacks of the object
+void ObjectBase::ExecuteCallback(const SYS::TimeDelay &)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ for (int i = 0; i < CALLBACK_PRIORITIES; ++i) {
+    if (myNewCallbacks[i].load()) {
+        ScheduleCallbacks((CallbackPriority)i);
     }
  }
 }
 
-int ObjectBase::GetCallbackTimeLimit(void) const
+/// Moves the new callbacks after the pending ones, in the order of their arrival (Render Thread)
+void ObjectBase::TakeNewCallbacks(CallbackPriority priority)
 {
- return GetRenderer().GetCallbackTimeLimit();
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ CallbackRequest * request = myNewCallbacks[priority].exchange(nullptr, std::memory_order_acquire);
+
+ // The stack is in reverse order:
+ CallbackRequest * reversed = nullptr;
+ while (request) {
+    CallbackRequest * next = request->next;
+    request->next = reversed;
+    reversed = request;
+    request = next;
+ }
+
+ CallbackRequest ** last = &myCallbacks[priority];
+ while (*last) {
+    last = &(*last)->next;
+ }
+ *last = reversed;
+}
+
+/// Calls each pending \ref Glesly::ObjectBase::ObjectCallback::Execute() once (Render Thread)
+/*! \retval true    The object has callbacks to be executed in the next frames. */
+bool ObjectBase::RunCallbacks(CallbackPriority priority)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ TakeNewCallbacks(priority);
+
+ for (CallbackRequest ** i = &myCallbacks[priority]; *i; ) {
+    CallbackRequest * request = *i;
+    if (request->callback->Execute(*this)) {
+        *i = request->next; // Unchain
+        delete request;
+    } else {
+        i = &request->next;
+    }
+ }
+
+ if (myCallbacks[priority]) {
+    return true;
+ }
+
+ isCallbackScheduled[priority] = false;
+
+ // A new callback may have arrived after taking the stack:
+ return myNewCallbacks[priority].load() && !isCallbackScheduled[priority].exchange(true);
 }
 
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -12,10 +12,13 @@
 #define __GLESLY_SRC_OBJECT_BASE_H_INCLUDED__
 
 #include <list>
+#include <atomic>
 
 #include <glesly/object-list-base.h>
 #include <System/TimeElapsed.h>
 #include <glesly/object-ptr.h>
+#include <glesly/state-buffer.h>
+#include <glesly/pool-allocator.h>
 #include <International/utf8.h>
 #include <Debug/Debug.h>
 
@@ -26,11 +29,12 @@ namespace Glesly
     class Render;
     class ObjectGroup;
 
-    class ObjectBase
+    class ObjectBase: public Glesly::StateManager
     {
         friend class Render;
         friend class ObjectPtr;
         friend class ObjectGroup;
+        friend class ObjectStore;
 
      public:
         virtual ~ObjectBase();
@@ -83,22 +87,183 @@ namespace Glesly
          *  the next frame (and also call the function \ref ObjectBase::uninitGL()), therefore it
          *  will not be displayed any more. If there is no more references to this object, the
          *  object also will be deleted.
+         *  The object is removed from its store (see \ref ObjectBase::GetStore()) here, in a
+         *  writer session on the calling thread. The store keeps its reference until all of the
+         *  readers which could see it have finished, so the Render Thread needs no lock.
          *  \note   If other thread(s) keep references (\see ObjectPtr) than the object will not be
          *          deleted by the Render Thread, and can be used later again. To do this, call the
-         *          function \ref ObjectBase::ReinitGL(). */
-        inline void UnuseGL(void)
+         *          function \ref ObjectBase::ReinitGL().
+         *  \warning    It must not be called within an \ref ObjectList session of the list
+         *              containing this object.
+         *  \see Render::Retire() */
+        void UnuseGL(void);
+
+        /// Tells if the GL initialization of this object has been requested, but not done yet
+        /*! The requests are counted by \ref ObjectBase::ReinitGL(), and the Render Thread counts
+         *  them down when the function \ref ObjectBase::initGL() has been called.
+         *  \see Render::IsGLPending() */
+        virtual bool IsGLPending(void) const
         {
-            toBeDeleted = true;
+            return myGLRequests.load(std::memory_order_acquire) != 0;
+        }
+
+        /// Tells if the GL resources of this object have been initialized (Render Thread)
+        /*! It is set when \ref ObjectBase::initGL() has been called by the Render Thread, and
+         *  cleared when the resources are released (see \ref ObjectBase::uninitGL() and
+         *  \ref ObjectBase::EvictGL()). The objects not initialized yet are not drawn, e.g. if
+         *  the initialization is delayed by \ref Render::SetInitBudget(). */
+        inline bool IsGLInitialized(void) const
+        {
+            return isGLInitialized;
+        }
+
+        /// The store the object is in, or NULL
+        /*! It is set when the object is inserted into an \ref ObjectStore, and cleared when it
+         *  is removed. For an \ref ObjectsWithEffect it can be the store of any layer, not only
+         *  the top one.
+         *  \note   An object can be in one store at a time. */
+        inline Glesly::ObjectStore * GetStore(void) const
+        {
+            return myStore.load(std::memory_order_acquire);
+        }
+
+        /// Releases the GL resources while the object cannot be seen (Render Thread)
+        /*! It is called on the Objects of the buried layers, see
+         *  \ref ObjectsWithEffect::SetEvictionDepth(). The function \ref ObjectBase::uninitGL()
+         *  is called, and the resources are uploaded again by \ref ObjectBase::RestoreGL().
+         *  \see ObjectBase::CanEvictGL() */
+        virtual void EvictGL(void);
+
+        /// Requests the GL initialization again, if the object has been evicted (Render Thread)
+        /*! The initialization is done within the budget of the Render, see
+         *  \ref Render::SetInitBudget(). Nothing is done if the object has been initialized
+         *  since the eviction, or its initialization has already been requested by
+         *  \ref ObjectBase::ReinitGL(). */
+        virtual void RestoreGL(void);
+
+        /// Tells if \ref ObjectBase::initGL() can be called again after an eviction
+        /*! The objects are evicted only if they keep the host-side sources of their GL
+         *  resources (e.g. the vertices and the bitmaps). The objects freeing them after the
+         *  upload must return false here. */
+        virtual bool CanEvictGL(void) const
+        {
+            return true;
+        }
+
+        /// Sets the area of the screen covered by this object
+        /*! If it is known, only the changes of this area are redrawn by \ref ObjectBase::Damage(),
+         *  and the object is not drawn if it is out of the redrawn area. Both the old and the new
+         *  area are damaged.
+         *  \param  bounds  The bounding rectangle in window coordinates, or an empty rectangle if
+         *                  it is not known.
+         *  \note   It can be called from any thread. */
+        inline void SetScreenBounds(const Glesly::DamageRect & bounds)
+        {
+            DamageRect area = DamageRect::Unpack(myScreenBounds.exchange(bounds.Pack()));
+            if (area.IsEmpty() || bounds.IsEmpty()) {
+                Redraw::Request();
+            } else {
+                Redraw::Request(area.Add(bounds));
+            }
+        }
+
+        inline Glesly::DamageRect GetScreenBounds(void) const
+        {
+            return DamageRect::Unpack(myScreenBounds.load(std::memory_order_relaxed));
+        }
+
+        /// Requests redraw of this object
+        /*! It must be called if the object has been changed by other means than the automatically
+         *  tracked ones (see \ref Redraw), e.g. its texture has been updated. */
+        inline void Damage(void)
+        {
+            DamageRect area = GetScreenBounds();
+            if (area.IsEmpty()) {
+                Redraw::Request();
+            } else {
+                Redraw::Request(area);
+            }
         }
 
         /// Called from the Timer Thread, after each frame
-        /*! This function can be used to update the object's state.
+        /*! This function can be used to update the object's state.<br>
+         *  Note that the Render Thread draws the next frame meanwhile. The variables used for
+         *  drawing should be modified via \ref Glesly::BufferedState, they are committed after this
+         *  function and published for the Render Thread before the next frame is drawn.
          *  \warning    All of the objects are notified after each frame this way, so keep in mind to make
          *              these functions fast enough. */
         virtual void Timer(void)
         {
         }
 
+        /// Commits the states modified in the actual timer pass (Timer Thread)
+        /*! It is called after \ref ObjectBase::Timer(), see \ref Render::CommitPass(). The groups
+         *  commit the states of their members too. */
+        virtual void CommitFrameStates(Glesly::Render & render);
+
+        /// Tells if the function \ref ObjectBase::Timer() can be called from any thread
+        /*! If it returns true, the timer of this object can be executed by a \ref TimerPool, in
+         *  parallel with the timers of other objects. It is allowed only if the timer function
+         *  modifies nothing but this object's own state.
+         *  \see Render::SetTimerPool() */
+        virtual bool IsTimerThreadSafe(void) const
+        {
+            return false;
+        }
+
+        /// Special values of \ref ObjectBase::SetTimerPeriod()
+        static constexpr int64_t TIMER_EVERY_FRAME = 0;
+        static constexpr int64_t TIMER_OFF = -1;
+
+        void SetTimerPeriod(int64_t period);
+        void SetTimerOnce(int64_t delay);
+
+        /// The priorities of the callbacks, see \ref ObjectBase::Execute()
+        enum CallbackPriority
+        {
+            CALLBACK_PRIORITY_HIGH = 0,     ///< Executed before any normal callback
+            CALLBACK_PRIORITY_NORMAL,
+            CALLBACK_PRIORITIES
+
+        }; // enum Glesly::ObjectBase::CallbackPriority
+
+        /// The classes of the GL initialization order
+        /*! The classes are initialized in this order, see \ref ObjectBase::GetInitPriority(). */
+        enum InitPriority
+        {
+            INIT_PRIORITY_UI = 0,       ///< Parts of the user interface
+            INIT_PRIORITY_VISIBLE,      ///< Objects visible on the screen
+            INIT_PRIORITY_BACKGROUND    ///< Objects not visible yet
+
+        }; // enum Glesly::ObjectBase::InitPriority
+
+        /// Tells when the object should be initialized, relative to the others
+        /*! It is called by the Render Thread when the request of the initialization is taken, see
+         *  \ref ObjectBase::ReinitGL(). The default implementation takes the enabled objects
+         *  visible. */
+        virtual InitPriority GetInitPriority(void) const
+        {
+            return myEnabled ? INIT_PRIORITY_VISIBLE : INIT_PRIORITY_BACKGROUND;
+        }
+
+        /// The distance of the object from the camera
+        /*! Within the same \ref ObjectBase::InitPriority, the nearer objects are initialized
+         *  first. The default implementation returns 0, it means no preference; the class
+         *  \ref Object derives it from its Projection Matrix. */
+        virtual float GetCameraDistance(void) const
+        {
+            return 0.0f;
+        }
+
+        /// The estimated amount of data uploaded by \ref ObjectBase::initGL(), in bytes
+        /*! It is used to limit the uploads in one frame, see \ref Render::SetInitBudget(). The
+         *  default implementation returns 0, such objects are limited by the time only; the
+         *  class \ref Object sums the sizes of its vertex buffers and textures. */
+        virtual size_t GetUploadSize(void) const
+        {
+            return 0;
+        }
+
      protected:
         ObjectBase(Glesly::ObjectListBase & base);
 
@@ -112,8 +277,42 @@ namespace Glesly
         inline ObjectPtr Create(bool do_initialize = true)
         {
             SYS_DEBUG_MEMBER(DM_GLESLY);
-            ObjectPtr p(this);
+            return Attach(ObjectPtr(this), do_initialize);
+        }
+
+        /// Create an object of the given class, allocated from the pool of the class
+        /*! It can be used instead of 'new' and \ref ObjectBase::Create(). The object and the
+         *  control block of the smart pointer are allocated in one block, from a
+         *  \ref SlabPool of this type. It is useful for the objects created and deleted
+         *  frequently, e.g.:
+         *  \code
+         *  static Glesly::ObjectPtr Create(Glesly::Render & render)
+         *  {
+         *      return Glesly::ObjectBase::Allocate<Marker>(render);
+         *  }
+         *  \endcode
+         *  \param  args    The parameters of the constructor, it can be protected. */
+        template <class T, typename... Args>
+        static inline ObjectPtr Allocate(Args &&... args)
+        {
+            SYS_DEBUG_STATIC(DM_GLESLY);
+            MEM::shared_ptr<ObjectBase> p = std::allocate_shared<PooledObject<T> >(PoolAllocator<PooledObject<T> >(), std::forward<Args>(args)...);
+            return p->Attach(p, true);
+        }
+
+        /// Makes the smart pointer the owner of this object
+        inline ObjectPtr Attach(const ObjectPtr & p, bool do_initialize)
+        {
             mySelf = p;
+            // The timer and the callbacks set by the constructor can be registered now:
+            if (myTimerPeriod != TIMER_OFF) {
+                RegisterTimer(myTimerPeriod, isTimerOnce);
+            }
+            for (int i = 0; i < CALLBACK_PRIORITIES; ++i) {
+                if (myNewCallbacks[i].load()) {
+                    ScheduleCallbacks((CallbackPriority)i);
+                }
+            }
             if (do_initialize) {
                 ReinitGL();
             }
@@ -137,7 +336,7 @@ namespace Glesly
          private:
             /*! Only the class \ref Glesly::ObjectBase is allowed to call the callback
              *  function \ref ObjectCallback::Execute().
-             *  \see ObjectBase::ExecuteCallback() for details. */
+             *  \see ObjectBase::Execute() for details. */
             friend class Glesly::ObjectBase;
 
             /// Callback function to execute sometning on the given object
@@ -152,15 +351,17 @@ namespace Glesly
         }; // class ObjectCallback
 
         void ReinitGL(void);
-        void ExecuteCallback(const SYS::TimeDelay & frame_start_time);
 
         typedef MEM::shared_ptr<ObjectCallback> ObjectCallbackPtr;
 
-        inline void Execute(ObjectCallbackPtr callback)
-        {
-            // TODO Lock?
-            myCallbacks.push_back(callback);
-        }
+        void Execute(ObjectCallbackPtr callback, CallbackPriority priority = CALLBACK_PRIORITY_NORMAL);
+
+        /// Schedules the pending callbacks of the object
+        /*! \deprecated    The callbacks are executed by the Render in its callback phase, within
+         *                  a common budget, see \ref ObjectBase::Execute(). This function only
+         *                  makes sure that the object is scheduled there.
+         *  \param  frame_start_time    Not used. */
+        void ExecuteCallback(const SYS::TimeDelay & frame_start_time);
 
         ObjectWeak mySelf;
 
@@ -192,17 +393,97 @@ namespace Glesly
         {
         }
 
-        int GetCallbackTimeLimit(void) const;
+        void RegisterTimer(int64_t period, bool once);
+        void ScheduleCallbacks(CallbackPriority priority);
+        void TakeNewCallbacks(CallbackPriority priority);
+        bool RunCallbacks(CallbackPriority priority);
 
         Glesly::ObjectListBase & myBase;
 
         bool myEnabled;
 
-        int myCallbackTimeLimit;
+        /// An element of the lists of the callbacks
+        /*! The elements are allocated from a \ref SlabPool, so the steady flow of the callbacks
+         *  does not use the heap. */
+        struct CallbackRequest
+        {
+            static inline void * operator new(size_t)
+            {
+                return SlabPool::Get<CallbackRequest>().Allocate();
+            }
+
+            static inline void operator delete(void * p)
+            {
+                SlabPool::Get<CallbackRequest>().Free(p);
+            }
+
+            CallbackRequest * next;
+
+            ObjectCallbackPtr callback;
+
+        }; // struct Glesly::ObjectBase::CallbackRequest
+
+        /// The top of the stacks of the callbacks not taken by the Render Thread yet
+        std::atomic<CallbackRequest *> myNewCallbacks[CALLBACK_PRIORITIES];
+
+        /// Tells if the object is in the callback queue of the Render
+        std::atomic<bool> isCallbackScheduled[CALLBACK_PRIORITIES];
+
+        /// The callbacks to be executed again, in the order of their arrival (Render Thread only)
+        CallbackRequest * myCallbacks[CALLBACK_PRIORITIES];
+
+        /// The next one in the callback queue of the Render, see \ref Render::ScheduleCallbacks()
+        ObjectBase * myCallbackNext[CALLBACK_PRIORITIES];
+
+        /// Keeps the object alive while it is in the callback queue of the Render
+        ObjectPtr myCallbackSelf[CALLBACK_PRIORITIES];
+
+        /// Set by \ref ObjectBase::UnuseGL(), until the Render Thread drops the object
+        std::atomic<bool> toBeDeleted;
+
+        /// The next one on the retire stack of the Render
+        ObjectBase * myRetireNext;
+
+        /// Keeps the object alive while it is on the retire stack
+        ObjectPtr myRetireSelf;
+
+        /// See \ref ObjectBase::GetStore()
+        std::atomic<Glesly::ObjectStore *> myStore;
+
+        /// The last timer pass this object has committed states in, see \ref Render::CommitObject()
+        std::atomic<uint64_t> myCommitPass;
+
+        /// Set while the object is on the dirty stack or in the published list of the Render
+        std::atomic<bool> isStateDirty;
+
+        /// The next one on the dirty stack of the Render
+        ObjectBase * myDirtyNext;
+
+        /// Keeps the object alive while it is on the dirty stack
+        ObjectPtr myDirtySelf;
+
+        /// The number of GL initialization requests not done yet, see \ref ObjectBase::IsGLPending()
+        std::atomic<unsigned> myGLRequests;
+
+        /// Set by \ref ObjectBase::EvictGL(), cleared when it is initialized again (Render Thread only)
+        bool isEvicted;
+
+        /// See \ref ObjectBase::IsGLInitialized() (Render Thread only)
+        bool isGLInitialized;
+
+        /// Incremented by each timer registration, the older ones are cancelled this way
+        std::atomic<uint32_t> myTimerGeneration;
+
+        /// The last registered timer period, see \ref ObjectBase::SetTimerPeriod()
+        int64_t myTimerPeriod;
+
+        bool isTimerOnce;
 
-        std::list<ObjectCallbackPtr> myCallbacks;
+        /// Keeps the object alive while its timer is being called (Timer Thread only)
+        ObjectPtr myTimerSelf;
 
-        bool toBeDeleted;
+        /// See \ref DamageRect::Pack()
+        std::atomic<uint64_t> myScreenBounds;
 
     }; // class ObjectBase
 
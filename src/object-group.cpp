@@ -10,6 +10,8 @@
 
 #include "object-group.h"
 
+#include <glesly/render.h>
+
 using namespace Glesly;
 
 void ObjectGroup::initGL(void)
@@ -26,8 +28,6 @@ void ObjectGroup::DrawFrame(const SYS::TimeDelay & frame_start_time)
     return;
  }
 
- ExecuteCallback(frame_start_time);
-
  ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
 
  if (!p) {
@@ -36,10 +36,94 @@ void ObjectGroup::DrawFrame(const SYS::TimeDelay & frame_start_time)
     return;
  }
 
- SYS_DEBUG(DL_INFO2, "Having " << p->size() << " objects");
+ Objects::Reader objects(*p);
+
+ SYS_DEBUG(DL_INFO2, "Having " << objects.size() << " objects");
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    if ((*i)->IsGLInitialized()) {
+        (*i)->DrawFrame(frame_start_time);
+    }
+ }
+}
+
+void ObjectGroup::CommitFrameStates(Glesly::Render & render)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ render.CommitObject(*this);
+
+ ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
+
+ if (!p) {
+    return;
+ }
+
+ Objects::Reader objects(*p);
 
- for (ObjectListIterator i = p->begin(); i != p->end(); ++i) {
-    (*i)->DrawFrame(frame_start_time);
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    (*i)->CommitFrameStates(render);
+ }
+}
+
+/// The group is pending while any of its members is pending
+bool ObjectGroup::IsGLPending(void) const
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (ObjectBase::IsGLPending()) {
+    return true;
+ }
+
+ ObjectListPtr p = const_cast<ObjectGroup &>(*this).GetObjectListPtr(); // The pointer is copied here to solve thread safety
+
+ if (!p) {
+    return false;
+ }
+
+ Objects::Reader objects(*p);
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    if ((*i)->IsGLPending()) {
+        return true;
+    }
+ }
+
+ return false;
+}
+
+/// Evicts the members, the group itself has no GL resources
+void ObjectGroup::EvictGL(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
+
+ if (!p) {
+    return;
+ }
+
+ Objects::Reader objects(*p);
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    (*i)->EvictGL();
+ }
+}
+
+void ObjectGroup::RestoreGL(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
+
+ if (!p) {
+    return;
+ }
+
+ Objects::Reader objects(*p);
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    (*i)->RestoreGL();
  }
 }
 
@@ -53,9 +137,11 @@ bool ObjectGroup::MouseClick(float x, float y, int index, int count)
 
  ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
 
- SYS_DEBUG(DL_INFO2, "Having " << p->size() << " objects");
+ Objects::Reader objects(*p);
+
+ SYS_DEBUG(DL_INFO2, "Having " << objects.size() << " objects");
 
- for (ObjectListIterator i = p->begin(); i != p->end(); ++i) {
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
     if (!(*i)->IsEnabled()) {
         continue;
     }
@@ -77,7 +163,9 @@ void ObjectGroup::KeyboardClick(UTF8::WChar key)
 
  ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
 
- for (ObjectListIterator i = p->begin(); i != p->end(); ++i) {
+ Objects::Reader objects(*p);
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
     if (!(*i)->IsEnabled()) {
         continue;
     }
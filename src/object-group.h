@@ -24,6 +24,8 @@ namespace Glesly
             isInited(false)
         {
             SYS_DEBUG_MEMBER(DM_GLESLY);
+            // The group itself has no GL resources, the members are checked one by one:
+            isGLInitialized = true;
         }
 
         virtual ~ObjectGroup()
@@ -36,6 +38,11 @@ namespace Glesly
             return ObjectBase::GetRenderer();
         }
 
+        virtual bool IsGLPending(void) const override;
+        virtual void CommitFrameStates(Glesly::Render & render) override;
+        virtual void EvictGL(void) override;
+        virtual void RestoreGL(void) override;
+
      protected:
         virtual void DrawFrame(const SYS::TimeDelay & frame_start_time) override;
         virtual bool MouseClick(float x, float y, int index, int count) override;
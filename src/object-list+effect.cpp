@@ -0,0 +1,137 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Classes representing an object list with effects possibility
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "object-list+effect.h"
+#include <glesly/object-base.h>
+#include <glesly/render.h>
+#include <glesly/clock.h>
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ObjectsWithEffect:                                                          *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/// Activates the layer pushed by \ref ObjectsWithEffect::PushLayer() (Render Thread)
+/*! The new layer is prewarmed first: its effect is not started until the GL initialization
+ *  requests of the Render have been done (see \ref Render::IsGLPending()), so the effect is
+ *  not disturbed by the initGL() calls of the new Objects. The initialization is done by the Render within its budget, over
+ *  several frames if necessary, see \ref Render::SetInitBudget().<br>
+ *  When the layer is ready, the effect is started and \ref ObjectsWithEffect::LayerReady() is
+ *  called. A layer pushed meanwhile waits until the previous one is ready.<br>
+ *  The eviction and the delayed pops are also handled here, see
+ *  \ref ObjectsWithEffect::SetEvictionDepth().
+ *  \note   It is called by \ref Render::NextFrame() in each frame, after the initialization of
+ *          the pending Objects. */
+void ObjectsWithEffect::CheckNextLayer(Glesly::Render & render)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (isMemoryPressure.exchange(false)) {
+    EvictLayers();
+ }
+
+ if (myPendingPops) {
+    CheckPopLayer(render);
+ }
+
+ if (!myIncomingLayer) {
+    LayerCreatorPtr creator = myNextLayer;
+    if (!creator.get()) {
+        return;
+    }
+    myNextLayer.reset();
+    myIncomingLayer = creator->GetEffect(render);
+    myPrewarmStart = Clock::Now();
+ }
+
+ if (render.IsGLPending()) {
+    if (!myPrewarmLimit || Clock::Now() - myPrewarmStart < myPrewarmLimit) {
+        // Check it again in the next frame, even in render-on-demand mode:
+        Redraw::Request();
+        return;
+    }
+    SYS_DEBUG(DL_INFO1, "Prewarm time is over, starting the layer anyway");
+ }
+
+ SYS_DEBUG(DL_INFO1, "Layer is ready in " << (Clock::Now() - myPrewarmStart) << " ns");
+
+ // Put it on the stack:
+ LayerEffectPtr effect;
+ effect.swap(myIncomingLayer);
+ effect->SetPreviousObjects(GetObjectListPtr());
+ myLayers.push(effect);
+ effect->Start();
+ Redraw::Request();
+
+ LayerReady(effect);
+}
+
+/// Starts the pop effect when the layer below has been restored (Render Thread)
+/*! The re-upload of the evicted layer is started here, before the transition, within the
+ *  budget of the Render. One layer is popped at a time, the next pending pop is started in the
+ *  next frame. */
+void ObjectsWithEffect::CheckPopLayer(Glesly::Render & render)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (myLayers.size() <= 1) {
+    myPendingPops = 0;
+    myRestoreStart = 0;
+    return;
+ }
+
+ LayerEffectPtr & below = myLayers.GetLayer(1);
+
+ if (!myRestoreStart) {
+    myRestoreStart = Clock::Now();
+    below->Restore();
+ }
+
+ if (render.IsGLPending()) {
+    if (!myPrewarmLimit || Clock::Now() - myRestoreStart < myPrewarmLimit) {
+        Redraw::Request();
+        return;
+    }
+    SYS_DEBUG(DL_INFO1, "Restore time is over, popping the layer anyway");
+ }
+
+ myRestoreStart = 0;
+ GetActualEffect()->Drop(myLayers);
+ --myPendingPops;
+ Redraw::Request();
+}
+
+/// Evicts the layers buried deeper than the limit (Render Thread)
+/*! The layers visible during a transition are kept. */
+void ObjectsWithEffect::EvictLayers(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!myEvictionDepth) {
+    return;
+ }
+
+ // The layer below the top is displayed by the transitions:
+ size_t depth = myEvictionDepth;
+ if (depth < 2 && (IsEffectActive() || myPendingPops)) {
+    depth = 2;
+ }
+
+ SYS_DEBUG(DL_INFO1, "Evicting the layers from depth " << depth << " of " << myLayers.size());
+
+ for (; depth < myLayers.size(); ++depth) {
+    myLayers.GetLayer(depth)->Evict();
+ }
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
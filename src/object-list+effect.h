@@ -11,6 +11,8 @@
 #ifndef __GLESLY_SRC_OBJECT_LIST_EFFECT_H_INCLUDED__
 #define __GLESLY_SRC_OBJECT_LIST_EFFECT_H_INCLUDED__
 
+#include <atomic>
+
 #include <glesly/effects.h>
 #include <glesly/object-list-base.h>
 #include <Threads/Mutex.h>
@@ -22,39 +24,78 @@ namespace Glesly
     class ObjectsWithEffect: public Glesly::ObjectListBase
     {
      public:
-        inline void CheckNextLayer(Glesly::Render & render)
-        {
-            LayerCreatorPtr creator = myNextLayer;
-            if (creator.get()) {
-                myNextLayer.reset();
-                // Put it on the stack:
-                LayerEffectPtr effect = creator->GetEffect(render);
-                effect->SetPreviousObjects(GetObjectListPtr());
-                myLayers.push(effect);
-                effect->Start();
-            }
-        }
+        void CheckNextLayer(Glesly::Render & render);
 
         void PushLayer(LayerCreatorPtr creator)
         {
             myNextLayer = creator; // Don't worry if overwrites the previous one
+            Redraw::Request();
         }
 
         bool PopLayer(void)
         {
             SYS_DEBUG_MEMBER(DM_GLESLY);
             SYS_DEBUG(DL_INFO1, "size: " << myLayers.size());
-            // Make sure that the root effect is not removed:
-            if (myLayers.size() <= 1) {
+            // Make sure that the root effect is not removed, the delayed pops are also counted:
+            if (myLayers.size() <= 1 + myPendingPops) {
                 return false;
             }
             SYS_DEBUG(DL_INFO1, "size: " << myLayers.size() << " accepted!");
-            GetActualEffect()->Drop(myLayers);
+            if (myEvictionDepth) {
+                // The layer below may have been evicted, see ObjectsWithEffect::CheckPopLayer():
+                ++myPendingPops;
+            } else {
+                GetActualEffect()->Drop(myLayers);
+            }
+            Redraw::Request();
             return true;
         }
 
+        /// Tells if a new layer is being prewarmed, see \ref ObjectsWithEffect::CheckNextLayer()
+        inline bool IsLayerPending(void) const
+        {
+            return myIncomingLayer.get();
+        }
+
+        /// Limits the time of the prewarm of the new layers
+        /*! If the Objects of the new layer are not initialized within this time, its effect is
+         *  started anyway, and the rest is initialized while it is running.
+         *  \param  time_limit      In nanoseconds, 0 means no limit (the default). */
+        inline void SetPrewarmLimit(int64_t time_limit)
+        {
+            myPrewarmLimit = time_limit;
+        }
+
+        /// Sets the depth of the layers evicted under memory pressure
+        /*! The GL resources of the layers buried at least this deep below the top are released
+         *  when \ref ObjectsWithEffect::ReleaseMemory() is called, see
+         *  \ref ObjectBase::EvictGL(). They are restored when the layer above them is popped:
+         *  the effect of \ref ObjectsWithEffect::PopLayer() is started when the Objects have
+         *  been initialized again (see \ref ObjectsWithEffect::SetPrewarmLimit()).
+         *  \param  depth   The depth of the first evicted layer, 0 disables the eviction (the
+         *                  default). */
+        inline void SetEvictionDepth(unsigned depth)
+        {
+            myEvictionDepth = depth;
+        }
+
+        /// Signals memory pressure (any thread)
+        /*! The deep layers are evicted before the next frame, see
+         *  \ref ObjectsWithEffect::SetEvictionDepth(). */
+        inline void ReleaseMemory(void)
+        {
+            isMemoryPressure = true;
+            Redraw::Request();
+        }
+
      protected:
-        inline ObjectsWithEffect(void)
+        inline ObjectsWithEffect(void):
+            myPrewarmStart(0),
+            myPrewarmLimit(0),
+            myEvictionDepth(0),
+            isMemoryPressure(false),
+            myPendingPops(0),
+            myRestoreStart(0)
         {
             LayerEffectPtr root_effect = JumpEffect::Create();
             myLayers.push(root_effect);
@@ -80,13 +121,41 @@ namespace Glesly
             return GetActualEffect()->IsActive();
         }
 
+        /// Called when the new layer has been prewarmed, and its effect has been started (Render Thread)
+        virtual void LayerReady(const LayerEffectPtr & effect)
+        {
+        }
+
      private:
         SYS_DEFINE_CLASS_NAME("Glesly::ObjectsWithEffect");
 
         ObjectLayerStack myLayers;
 
+        void CheckPopLayer(Glesly::Render & render);
+        void EvictLayers(void);
+
         LayerCreatorPtr myNextLayer;
 
+        /// The layer waiting for the GL initialization of its Objects (Render Thread only)
+        LayerEffectPtr myIncomingLayer;
+
+        /// The start time of the prewarm of \ref ObjectsWithEffect::myIncomingLayer
+        int64_t myPrewarmStart;
+
+        int64_t myPrewarmLimit;
+
+        unsigned myEvictionDepth;
+
+        /// Set by \ref ObjectsWithEffect::ReleaseMemory()
+        std::atomic<bool> isMemoryPressure;
+
+        /// Counted by \ref ObjectsWithEffect::PopLayer() if the eviction is enabled
+        /*! The layers are popped one by one by \ref ObjectsWithEffect::CheckPopLayer(). */
+        std::atomic<unsigned> myPendingPops;
+
+        /// The start time of the restoration of the layer below the popped one, or 0
+        int64_t myRestoreStart;
+
     }; // class ObjectsWithEffect
 
 } // namespace Glesly
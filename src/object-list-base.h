@@ -12,9 +12,11 @@
 #define __GLESLY_SRC_OBJECT_LIST_BASE_H_INCLUDED__
 
 #include <glesly/object-ptr.h>
+#include <glesly/object-store.h>
 #include <Threads/Mutex.h>
 #include <International/utf8.h>
 #include <glesly/effect-ptr.h>
+#include <glesly/redraw.h>
 #include <Debug/Debug.h>
 
 SYS_DECLARE_MODULE(DM_GLESLY);
@@ -26,6 +28,19 @@ namespace Glesly
     class ObjectListBase
     {
      public:
+        /// Write access to the Objects
+        /*! The changes are collected while this object exists, and they are published to the
+         *  readers at once by its destructor. Adding or removing many Objects in one session
+         *  (preferably by the range functions) costs one copy of the array only:
+         *  \code
+         *  {
+         *      Glesly::Render::InitBatch batch(render);    // see Render::InitBatch
+         *      std::vector<Glesly::ObjectPtr> pois;
+         *      ...                                         // create the Objects
+         *      Glesly::ObjectList list = render.GetObjectList();
+         *      list.Append(pois.begin(), pois.end());
+         *  }
+         *  \endcode */
         class ObjectListInternal
         {
             friend class ObjectListBase;
@@ -35,23 +50,53 @@ namespace Glesly
 
             void Insert(ObjectPtr object);
             void Append(ObjectPtr object);
+            void Remove(ObjectBase * object);
             void Cleanup(void);
 
+            /// Inserts a range of Objects at the given position
+            /*! \see ObjectStore::Insert(size_t, Iterator, Iterator) */
+            template <class Iterator>
+            inline void Insert(size_t position, Iterator first, Iterator last)
+            {
+                myObjects->Insert(position, first, last);
+            }
+
+            template <class Iterator>
+            inline void Append(Iterator first, Iterator last)
+            {
+                myObjects->Append(first, last);
+            }
+
+            /// Removes a set of Objects
+            /*! \see ObjectStore::Remove(Iterator, Iterator) */
+            template <class Iterator>
+            inline void Remove(Iterator first, Iterator last)
+            {
+                myObjects->Remove(first, last);
+            }
+
+            /// Changes the drawing order of the Objects
+            /*! \see ObjectStore::Reorder() */
+            template <class Compare>
+            inline void Reorder(Compare less)
+            {
+                myObjects->Reorder(less);
+            }
+
+            inline size_t GetSize(void) const
+            {
+                return myObjects->GetSize();
+            }
+
          private:
             SYS_DEFINE_CLASS_NAME("Glesly::ObjectListBase::ObjectListInternal");
 
             ObjectListInternal(ObjectListBase & parent);
 
-            void CopyObjects(void);
-
-            ObjectListBase & myParent;
-
             Threads::Lock myLock;
 
             ObjectListPtr myObjects;
 
-            ObjectListPtr myModifiedObjects;
-
         }; // class ObjectListInternal
 
         inline ObjectListInternal GetObjectList(void)
@@ -75,7 +120,8 @@ namespace Glesly
         void KeyboardClick(UTF8::WChar ch);
 
      protected:
-        inline ObjectListBase(void)
+        inline ObjectListBase(void):
+            myObjects(new Objects)
         {
         }
 
@@ -94,7 +140,6 @@ namespace Glesly
     }; // class ObjectListBase
 
     inline ObjectListBase::ObjectListInternal::ObjectListInternal(ObjectListBase & parent):
-        myParent(parent),
         myLock(parent.GetObjectMutex()),
         myObjects(parent.GetObjectListPtr())
     {
@@ -104,45 +149,34 @@ namespace Glesly
     inline ObjectListBase::ObjectListInternal::~ObjectListInternal()
     {
         SYS_DEBUG_MEMBER(DM_GLESLY);
-        SYS_DEBUG(DL_INFO1, "Passing " << (myModifiedObjects ? myModifiedObjects->size() : 0) << " objects");
-        myParent.GetObjectListPtr() = myModifiedObjects;
+        myObjects->Publish();
+        Redraw::Request();
     }
 
-    inline void ObjectListBase::ObjectListInternal::CopyObjects(void)
+    inline void ObjectListBase::ObjectListInternal::Insert(ObjectPtr object)
     {
         SYS_DEBUG_MEMBER(DM_GLESLY);
-        if (!myModifiedObjects) {
-            if (myObjects) {
-                SYS_DEBUG(DL_INFO1, "Copying " << myObjects->size() << " objects");
-                myModifiedObjects.reset(new Objects(*myObjects));
-            } else {
-                SYS_DEBUG(DL_INFO1, "Creating empty container");
-                myModifiedObjects.reset(new Objects);
-            }
-        }
+        myObjects->Insert(object);
     }
 
-    inline void ObjectListBase::ObjectListInternal::Insert(ObjectPtr object)
+    inline void ObjectListBase::ObjectListInternal::Append(ObjectPtr object)
     {
         SYS_DEBUG_MEMBER(DM_GLESLY);
-        CopyObjects();
-        myModifiedObjects->push_front(object);
-        SYS_DEBUG(DL_INFO1, "ObjectListBase::ObjectListInternal::Insert(): size=" << myModifiedObjects->size());
+        myObjects->Append(object);
     }
 
-    inline void ObjectListBase::ObjectListInternal::Append(ObjectPtr object)
+    /// Removes the Object from the list
+    /*! \note   It does not call \ref ObjectBase::uninitGL(), see \ref ObjectBase::UnuseGL(). */
+    inline void ObjectListBase::ObjectListInternal::Remove(ObjectBase * object)
     {
         SYS_DEBUG_MEMBER(DM_GLESLY);
-        CopyObjects();
-        myModifiedObjects->push_back(object);
-        SYS_DEBUG(DL_INFO1, "ObjectListBase::ObjectListInternal::Append(): size=" << myModifiedObjects->size());
+        myObjects->Remove(object);
     }
 
     inline void ObjectListBase::ObjectListInternal::Cleanup(void)
     {
         SYS_DEBUG_MEMBER(DM_GLESLY);
-        CopyObjects();
-        myModifiedObjects->clear();
+        myObjects->Clear();
     }
 
     typedef ObjectListBase::ObjectListInternal ObjectList;
@@ -11,7 +11,6 @@
 #ifndef __GLESLY_SRC_OBJECT_PTR_H_INCLUDED__
 #define __GLESLY_SRC_OBJECT_PTR_H_INCLUDED__
 
-#include <list>
 #include <Memory/Memory.h>
 
 namespace Glesly
@@ -82,9 +81,19 @@ namespace Glesly
 
     }; // class Glesly::ObjectWrapper
 
-    typedef std::list<ObjectPtr> Objects;
+    class ObjectStore;
 
-    typedef Objects::iterator ObjectListIterator;
+    /// The container of the Objects
+    /*! \note   It was a std::list<ObjectPtr> before, the user code must be changed: the Objects
+     *          can be traversed only by an \ref ObjectStore::Reader, and modified only by an
+     *          \ref ObjectList. */
+    typedef ObjectStore Objects;
+
+    /// Iterator of \ref ObjectStore::Reader
+    /*! \note   It was a std::list iterator of \ref ObjectPtr before. Now it points to plain
+     *          pointers, so (*i)->Function() still works, but the references must be taken
+     *          explicitly, e.g. by (*i)->GetPtr(). */
+    typedef ObjectBase * const * ObjectListIterator;
 
     typedef MEM::shared_ptr<Objects> ObjectListPtr;
 
@@ -0,0 +1,329 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Object container with lock-free readers
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <sched.h>
+
+#include "object-store.h"
+#include "object-base.h"
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ObjectStore:                                                                *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+std::atomic<uint64_t> ObjectStore::myLastVersion(0);
+
+ObjectStore * ObjectStore::myRegistry = nullptr;
+
+Threads::Mutex ObjectStore::myRegistryMutex;
+
+std::vector<ObjectPtr> ObjectStore::myReleased;
+
+ObjectStore::ObjectStore(void):
+    myCurrent(new Snapshot),
+    myEpoch(1),
+    myModified(nullptr),
+    myRegistryNext(nullptr),
+    isRegistered(false)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myCurrent.load()->version = ++myLastVersion;
+
+ for (unsigned i = 0; i < MAX_READERS; ++i) {
+    mySlots[i].epoch = 0;
+ }
+}
+
+ObjectStore::~ObjectStore()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ {
+    Threads::Lock _l(myRegistryMutex);
+    if (isRegistered) {
+        for (ObjectStore ** i = &myRegistry; *i; i = &(*i)->myRegistryNext) {
+            if (*i == this) {
+                *i = myRegistryNext;
+                break;
+            }
+        }
+    }
+ }
+
+ // The Objects may be kept by others:
+ for (std::vector<ObjectPtr>::iterator i = myOwners.begin(); i != myOwners.end(); ++i) {
+    Release(**i);
+ }
+
+ for (std::vector<Retired>::iterator i = myRetired.begin(); i != myRetired.end(); ++i) {
+    delete i->snapshot;
+ }
+
+ for (std::vector<Snapshot *>::iterator i = myFree.begin(); i != myFree.end(); ++i) {
+    delete *i;
+ }
+
+ delete myModified;
+ delete myCurrent.load();
+}
+
+/// Registers a reader
+/*! \retval The slot of the reader, it must be cleared when the reader has finished. */
+std::atomic<uint64_t> * ObjectStore::Enter(void) const
+{
+ for (;;) {
+    uint64_t epoch = myEpoch.load();
+    for (unsigned i = 0; i < MAX_READERS; ++i) {
+        uint64_t free = 0;
+        if (mySlots[i].epoch.compare_exchange_strong(free, epoch)) {
+            return &mySlots[i].epoch;
+        }
+    }
+    // All of the slots are in use, it is unlikely but possible:
+    sched_yield();
+ }
+}
+
+/// Prepares the private copy of the array (writer)
+/*! A released array is reused if there is any, so its storage is not allocated again. */
+void ObjectStore::Modify(void)
+{
+ if (myModified) {
+    return;
+ }
+
+ const Snapshot & current = *myCurrent.load(std::memory_order_relaxed);
+
+ {
+    Threads::Lock _l(myRetiredMutex);
+    if (!myFree.empty()) {
+        myModified = myFree.back();
+        myFree.pop_back();
+    }
+ }
+
+ if (myModified) {
+    myModified->objects.assign(current.objects.begin(), current.objects.end());
+ } else {
+    myModified = new Snapshot(current);
+ }
+}
+
+/// Puts the Object to the front (writer)
+/*! The Objects are drawn in their order in the array. */
+void ObjectStore::Insert(const ObjectPtr & object)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ Modify();
+ myModified->objects.insert(myModified->objects.begin(), object.get());
+ myOwners.insert(myOwners.begin(), object);
+ Adopt(*object);
+}
+
+/// Puts the Object to the end (writer)
+void ObjectStore::Append(const ObjectPtr & object)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ Modify();
+ myModified->objects.push_back(object.get());
+ myOwners.push_back(object);
+ Adopt(*object);
+}
+
+/// Removes the Object at the next \ref ObjectStore::Publish() (writer)
+/*! The removals are collected, and executed in one pass over the array. */
+void ObjectStore::Remove(ObjectBase * object)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ Modify();
+ myRemovals.push_back(object);
+}
+
+/// Removes all of the Objects (writer)
+void ObjectStore::Clear(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ Modify();
+ myModified->objects.clear();
+ myRemovals.clear();
+ for (std::vector<ObjectPtr>::iterator i = myOwners.begin(); i != myOwners.end(); ++i) {
+    Release(**i);
+    myRemoved.push_back(*i);
+ }
+ myOwners.clear();
+}
+
+/// Makes the changes visible for the readers (writer)
+void ObjectStore::Publish(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!myModified) {
+    return;
+ }
+
+ ApplyRemovals();
+
+ SYS_DEBUG(DL_INFO1, "Publishing " << myModified->objects.size() << " objects, " << myRemoved.size() << " removed");
+
+ myModified->version = ++myLastVersion;
+
+ Snapshot * previous = myCurrent.exchange(myModified);
+ myModified = nullptr;
+
+ // The removed Objects are released after the lock, because deleting them may take time:
+ std::vector<ObjectPtr> released;
+ bool pending;
+
+ {
+    Threads::Lock _l(myRetiredMutex);
+    myRetired.push_back(Retired());
+    Retired & retired = myRetired.back();
+    retired.snapshot = previous;
+    retired.epoch = myEpoch.fetch_add(1);
+    retired.objects.swap(myRemoved);
+    Reclaim(released);
+    pending = !myRetired.empty();
+ }
+
+ if (pending) {
+    Register();
+ }
+}
+
+/// Executes the collected removals in one pass (writer)
+void ObjectStore::ApplyRemovals(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (myRemovals.empty()) {
+    return;
+ }
+
+ std::sort(myRemovals.begin(), myRemovals.end());
+
+ size_t kept = 0;
+ for (size_t i = 0; i < myOwners.size(); ++i) {
+    if (std::binary_search(myRemovals.begin(), myRemovals.end(), myOwners[i].get())) {
+        Release(*myOwners[i]);
+        myRemoved.push_back(myOwners[i]);
+    } else {
+        myOwners[kept] = myOwners[i];
+        myModified->objects[kept] = myModified->objects[i];
+        ++kept;
+    }
+ }
+
+ myOwners.resize(kept);
+ myModified->objects.resize(kept);
+ myRemovals.clear();
+}
+
+/// Records this store in the Object, see \ref ObjectBase::GetStore() (writer)
+void ObjectStore::Adopt(ObjectBase & object)
+{
+ object.myStore = this;
+}
+
+/// Clears the store of the Object, if it has not been moved to another store meanwhile (writer)
+void ObjectStore::Release(ObjectBase & object)
+{
+ ObjectStore * self = this;
+ object.myStore.compare_exchange_strong(self, nullptr);
+}
+
+/// Frees the retired arrays not used by any reader (writer or Render Thread)
+/*! The arrays are kept for reuse, see \ref ObjectStore::Modify().
+ *  \param  released    The references of the removed Objects are moved here, the caller
+ *                      releases them after the lock.
+ *  \note   It must be called with \ref ObjectStore::myRetiredMutex locked. */
+void ObjectStore::Reclaim(std::vector<ObjectPtr> & released)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ uint64_t oldest = UINT64_MAX;
+ for (unsigned i = 0; i < MAX_READERS; ++i) {
+    uint64_t epoch = mySlots[i].epoch.load();
+    if (epoch && epoch < oldest) {
+        oldest = epoch;
+    }
+ }
+
+ // The readers started in a later epoch have already got a newer array:
+ size_t count = 0;
+ for (; count < myRetired.size() && myRetired[count].epoch < oldest; ++count) {
+    Retired & retired = myRetired[count];
+    myFree.push_back(retired.snapshot);
+    if (released.empty()) {
+        released.swap(retired.objects);
+    } else {
+        for (std::vector<ObjectPtr>::iterator i = retired.objects.begin(); i != retired.objects.end(); ++i) {
+            released.push_back(std::move(*i));
+        }
+        retired.objects.clear();
+    }
+ }
+
+ myRetired.erase(myRetired.begin(), myRetired.begin() + count);
+}
+
+/// Puts the store to the list of \ref ObjectStore::ReclaimAll() (writer)
+void ObjectStore::Register(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ Threads::Lock _l(myRegistryMutex);
+
+ if (!isRegistered) {
+    isRegistered = true;
+    myRegistryNext = myRegistry;
+    myRegistry = this;
+ }
+}
+
+/// Frees the retired arrays of all of the stores (Render Thread)
+/*! It is called once per frame by \ref Main::Run(), so the removed Objects are released even
+ *  if their store is not modified any more. Only the stores having retired arrays are
+ *  checked. The Objects are released after the locks. */
+void ObjectStore::ReclaimAll(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ {
+    Threads::Lock _l(myRegistryMutex);
+    for (ObjectStore ** i = &myRegistry; *i; ) {
+        ObjectStore & store = **i;
+        bool pending;
+        {
+            Threads::Lock _s(store.myRetiredMutex);
+            store.Reclaim(myReleased);
+            pending = !store.myRetired.empty();
+        }
+        if (pending) {
+            i = &store.myRegistryNext;
+        } else {
+            store.isRegistered = false;
+            *i = store.myRegistryNext;
+        }
+    }
+ }
+
+ myReleased.clear();
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
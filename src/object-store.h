@@ -0,0 +1,281 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Object container with lock-free readers
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_OBJECT_STORE_H_INCLUDED__
+#define __GLESLY_SRC_OBJECT_STORE_H_INCLUDED__
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <glesly/object-ptr.h>
+#include <Threads/Mutex.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// Container of the Objects of a Render, a group or a layer
+    /*! The readers (the Render Thread, the Timer Thread, the input handlers) traverse an
+     *  immutable array of plain pointers, see \ref ObjectStore::Reader. They do not lock, and do
+     *  not touch the reference counters of the Objects.<br>
+     *  The writer collects the changes in a private copy of the array, and publishes it at once
+     *  by \ref ObjectStore::Publish(). The previous array and the references of the removed
+     *  Objects are kept until all of the readers which could see them have finished: each reader
+     *  announces the epoch it has started in, and a retired array is released only if all of the
+     *  active readers started after it was replaced. It is checked by the writer at publish,
+     *  and once per frame by the Render Thread (see \ref ObjectStore::ReclaimAll()), so the
+     *  removed Objects are released even if the store is not modified any more. The readers
+     *  never lock, and never release anything.<br>
+     *  The replaced arrays are reused by the next modifications.
+     *  \note   The writer functions must be serialized, it is done by \ref ObjectList. */
+    class ObjectStore
+    {
+        struct Snapshot;
+
+     public:
+        ObjectStore(void);
+        ~ObjectStore();
+
+        /// Read access to the actual Objects
+        /*! It keeps the array alive while it exists, so it should not be kept longer than one
+         *  pass over the Objects. */
+        class Reader
+        {
+         public:
+            inline Reader(const ObjectStore & store):
+                mySlot(store.Enter()),
+                mySnapshot(store.myCurrent.load())
+            {
+            }
+
+            /// Leaves the store, the arrays are released later by the writer or the Render Thread
+            inline ~Reader()
+            {
+                mySlot->store(0, std::memory_order_release);
+            }
+
+            inline ObjectListIterator begin(void) const
+            {
+                return mySnapshot->objects.data();
+            }
+
+            inline ObjectListIterator end(void) const
+            {
+                return mySnapshot->objects.data() + mySnapshot->objects.size();
+            }
+
+            inline size_t size(void) const
+            {
+                return mySnapshot->objects.size();
+            }
+
+            inline bool empty(void) const
+            {
+                return mySnapshot->objects.empty();
+            }
+
+            /// Identifies the array, it is unique among all of the stores
+            /*! The equal versions mean the same Objects in the same order, so the data derived
+             *  from the array can be kept until it changes, see \ref Render::SetDrawBuckets(). */
+            inline uint64_t GetVersion(void) const
+            {
+                return mySnapshot->version;
+            }
+
+         private:
+            SYS_DEFINE_CLASS_NAME("Glesly::ObjectStore::Reader");
+
+            std::atomic<uint64_t> * mySlot;
+
+            const Snapshot * mySnapshot;
+
+        }; // class Glesly::ObjectStore::Reader
+
+        void Insert(const ObjectPtr & object);
+        void Append(const ObjectPtr & object);
+        void Remove(ObjectBase * object);
+        void Clear(void);
+        void Publish(void);
+
+        static void ReclaimAll(void);
+
+        /// Inserts a range of Objects (writer)
+        /*! \param  position    The index of the first inserted Object. The Objects removed in
+         *                      the same session are still counted here.
+         *  \param  first       The first Object to insert (a forward iterator of \ref ObjectPtr).
+         *  \param  last        The end of the range. */
+        template <class Iterator>
+        inline void Insert(size_t position, Iterator first, Iterator last)
+        {
+            Modify();
+            ASSERT(position <= myOwners.size(), "insert position is out of range: " << position << " > " << myOwners.size());
+            size_t count = std::distance(first, last);
+            myOwners.insert(myOwners.begin() + position, first, last);
+            myModified->objects.insert(myModified->objects.begin() + position, count, nullptr);
+            for (size_t i = position; i < position + count; ++i) {
+                myModified->objects[i] = myOwners[i].get();
+                Adopt(*myOwners[i]);
+            }
+        }
+
+        template <class Iterator>
+        inline void Append(Iterator first, Iterator last)
+        {
+            Insert(myOwners.size(), first, last);
+        }
+
+        /// Removes a set of Objects at the next \ref ObjectStore::Publish() (writer)
+        /*! \param  first       The first Object to remove, an iterator of either \ref ObjectPtr
+         *                      or ObjectBase pointers.
+         *  \param  last        The end of the range. */
+        template <class Iterator>
+        inline void Remove(Iterator first, Iterator last)
+        {
+            Modify();
+            for (; first != last; ++first) {
+                myRemovals.push_back(GetPointer(*first));
+            }
+        }
+
+        /// Sorts the Objects, and so changes their drawing order (writer)
+        /*! \param  less    Function object to compare two Objects: bool less(const ObjectBase &, const ObjectBase &)
+         *  \note   The sort is stable, the Objects having the same rank keep their order. */
+        template <class Compare>
+        inline void Reorder(Compare less)
+        {
+            Modify();
+            ApplyRemovals();
+            std::stable_sort(myOwners.begin(), myOwners.end(), [&less](const ObjectPtr & a, const ObjectPtr & b) { return less(*a, *b); });
+            for (size_t i = 0; i < myOwners.size(); ++i) {
+                myModified->objects[i] = myOwners[i].get();
+            }
+        }
+
+        /// The number of Objects, including the changes not published yet (writer)
+        inline size_t GetSize(void) const
+        {
+            return myOwners.size();
+        }
+
+        /// The maximum number of readers active at the same time
+        static constexpr unsigned MAX_READERS = 16;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::ObjectStore");
+
+        ObjectStore(const ObjectStore &) = delete;
+        ObjectStore & operator=(const ObjectStore &) = delete;
+
+        std::atomic<uint64_t> * Enter(void) const;
+        void Modify(void);
+        void ApplyRemovals(void);
+        void Reclaim(std::vector<ObjectPtr> & released);
+        void Register(void);
+        void Adopt(ObjectBase & object);
+        void Release(ObjectBase & object);
+
+        static inline ObjectBase * GetPointer(const ObjectPtr & object)
+        {
+            return object.get();
+        }
+
+        static inline ObjectBase * GetPointer(ObjectBase * object)
+        {
+            return object;
+        }
+
+        /// One published array
+        struct Snapshot
+        {
+            std::vector<ObjectBase *> objects;
+
+            /// Set when the array is published, see \ref ObjectStore::Reader::GetVersion()
+            uint64_t version;
+
+        }; // struct Glesly::ObjectStore::Snapshot
+
+        /// A replaced array, waiting for the readers to finish
+        struct Retired
+        {
+            Snapshot * snapshot;
+
+            /// The epoch when the array was replaced
+            uint64_t epoch;
+
+            /// The references of the Objects removed from the array
+            std::vector<ObjectPtr> objects;
+
+        }; // struct Glesly::ObjectStore::Retired
+
+        /// The epoch of an active reader, or 0 if the slot is free
+        struct Slot
+        {
+            std::atomic<uint64_t> epoch;
+
+            /// Keeps the slots in separate cache lines
+            char padding[64 - sizeof(std::atomic<uint64_t>)];
+
+        }; // struct Glesly::ObjectStore::Slot
+
+        std::atomic<Snapshot *> myCurrent;
+
+        std::atomic<uint64_t> myEpoch;
+
+        mutable Slot mySlots[MAX_READERS];
+
+        /// The array under modification, or NULL if there is no change (writer only)
+        Snapshot * myModified;
+
+        /// The references of the Objects, in the order of \ref ObjectStore::myModified (writer only)
+        std::vector<ObjectPtr> myOwners;
+
+        /// The Objects to be removed at the next publish (writer only)
+        std::vector<ObjectBase *> myRemovals;
+
+        /// The references of the removed Objects (writer only)
+        std::vector<ObjectPtr> myRemoved;
+
+        /// The replaced arrays, in the order of their epochs, see \ref ObjectStore::Reclaim()
+        std::vector<Retired> myRetired;
+
+        /// The released arrays, they are reused by \ref ObjectStore::Modify()
+        std::vector<Snapshot *> myFree;
+
+        /// Protects the retired and the free arrays, the Render Thread also releases them
+        Threads::Mutex myRetiredMutex;
+
+        /// The next store in the list of \ref ObjectStore::ReclaimAll() (protected by \ref ObjectStore::myRegistryMutex)
+        ObjectStore * myRegistryNext;
+
+        /// Tells if the store is in the list of \ref ObjectStore::ReclaimAll()
+        bool isRegistered;
+
+        /// The last version given to an array
+        static std::atomic<uint64_t> myLastVersion;
+
+        /// The stores having retired arrays, see \ref ObjectStore::ReclaimAll()
+        static ObjectStore * myRegistry;
+
+        static Threads::Mutex myRegistryMutex;
+
+        /// The references released by \ref ObjectStore::ReclaimAll() (Render Thread only)
+        static std::vector<ObjectPtr> myReleased;
+
+    }; // class ObjectStore
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_OBJECT_STORE_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
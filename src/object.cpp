@@ -10,6 +10,7 @@
 
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
+#include <math.h>
 
 #include <glesly/shader.h>
 #include <glesly/error.h>
@@ -24,7 +25,8 @@ using namespace Glesly;
 
 Object::Object(ObjectListBase & base):
     ObjectBase(base),
-    p_matrix(*this, "p_matrix", myProjection)
+    p_matrix(*this, "p_matrix", myProjection),
+    myNextProjection(*this, myProjection, GetRenderer().GetInterpolation())
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 }
@@ -62,8 +64,6 @@ void Object::DrawFrame(const SYS::TimeDelay & frame_start_time)
     return;
  }
 
- ExecuteCallback(frame_start_time);
-
  InitGLVariables();
  ActivateVariables();
  BufferVariables();
@@ -71,6 +71,17 @@ void Object::DrawFrame(const SYS::TimeDelay & frame_start_time)
  UnbufferVariables();
 }
 
+float Object::GetCameraDistance(void) const
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ float x = myProjection.GetPositionX();
+ float y = myProjection.GetPositionY();
+ float z = myProjection.GetPositionZ();
+
+ return sqrtf(x*x + y*y + z*z);
+}
+
 bool Object::MouseClick(float x, float y, int index, int count)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
@@ -40,12 +40,26 @@ namespace Glesly
             return GetRenderer().GetUniformLocationSafe(name);
         }
 
+        virtual Glesly::Shaders::UniformCache * GetUniformCache(void) const override
+        {
+            return GetRenderer().GetUniformCache();
+        }
+
         inline virtual void uninitGL(void) override
         {
             SYS_DEBUG_MEMBER(DM_GLESLY);
             Glesly::Shaders::VarManager::UninitGL();
         }
 
+        /// The distance of the object's origin, as placed by its Projection Matrix
+        virtual float GetCameraDistance(void) const override;
+
+        /// The size of the vertex buffers and the textures of the object
+        virtual size_t GetUploadSize(void) const override
+        {
+            return GetAttribsUploadSize() + GetUniformsUploadSize();
+        }
+
         inline GLint GetUniformLocation(const char * name) const
         {
             return GetRenderer().GetUniformLocation(name);
@@ -66,6 +80,15 @@ namespace Glesly
             return myProjection;
         }
 
+        /// The Projection Matrix to be modified by the Timer Thread
+        /*! It is used from the next frame, when the Render Thread publishes it. If the simulation
+         *  runs in fixed steps, the drawn projection is blended between the last two steps.
+         *  \see ObjectBase::Timer(), Main::SetSimulationRate() */
+        inline Glesly::Transformation & GetNextProjection(void)
+        {
+            return myNextProjection.Get();
+        }
+
      protected:
         Object(ObjectListBase & renderer);
 
@@ -82,6 +105,8 @@ namespace Glesly
 
         Glesly::Shaders::UniformMatrix_ref<float, 4> p_matrix;
 
+        Glesly::InterpolatedState<Glesly::Transformation> myNextProjection;
+
     }; // class Object
 
 } // namespace Glesly
@@ -0,0 +1,85 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Per-type pool allocation of the Objects
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+
+#include "pool-allocator.h"
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class SlabPool:                                                                   *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*! \param  size    The size of the blocks.
+ *  \param  align   The alignment of the blocks, it cannot be stricter than the alignment of the
+ *                  global operator new. */
+SlabPool::SlabPool(size_t size, size_t align):
+    myBlockSize(0),
+    myBlocksPerChunk(0),
+    myFree(nullptr)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ASSERT(align <= alignof(std::max_align_t), "too strict alignment: " << align);
+
+ // Each block must be able to hold the free list pointer, and keep the alignment:
+ size = std::max(size, sizeof(Block));
+ myBlockSize = (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+ myBlocksPerChunk = std::max(CHUNK_SIZE / myBlockSize, (size_t)1);
+
+ SYS_DEBUG(DL_INFO1, "Block size: " << myBlockSize << ", " << myBlocksPerChunk << " blocks per chunk");
+}
+
+/// Takes a free block, or allocates a new chunk if there is none (any thread)
+void * SlabPool::Allocate(void)
+{
+ Threads::Lock _l(myMutex);
+
+ if (!myFree) {
+    AddChunk();
+ }
+
+ Block * block = myFree;
+ myFree = block->next;
+
+ return block;
+}
+
+/// Gives back a block to the pool (any thread)
+void SlabPool::Free(void * block)
+{
+ Threads::Lock _l(myMutex);
+
+ Block * free = static_cast<Block *>(block);
+ free->next = myFree;
+ myFree = free;
+}
+
+void SlabPool::AddChunk(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ char * chunk = static_cast<char *>(::operator new(myBlockSize * myBlocksPerChunk));
+ myChunks.push_back(chunk);
+
+ SYS_DEBUG(DL_INFO2, "New chunk #" << myChunks.size() << " of " << myBlocksPerChunk << " blocks");
+
+ // In reverse order, so the blocks are used in the order of their addresses:
+ for (size_t i = myBlocksPerChunk; i > 0; --i) {
+    Block * block = reinterpret_cast<Block *>(chunk + (i - 1) * myBlockSize);
+    block->next = myFree;
+    myFree = block;
+ }
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
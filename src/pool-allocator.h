@@ -0,0 +1,145 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Per-type pool allocation of the Objects
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_POOL_ALLOCATOR_H_INCLUDED__
+#define __GLESLY_SRC_POOL_ALLOCATOR_H_INCLUDED__
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <utility>
+
+#include <Threads/Mutex.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// Fixed size blocks, allocated in chunks
+    /*! The freed blocks are kept for reuse, the chunks are never released. It is the right
+     *  choice for the objects created and deleted frequently, see \ref PoolAllocator. */
+    class SlabPool
+    {
+     public:
+        SlabPool(size_t size, size_t align);
+
+        void * Allocate(void);
+        void Free(void * block);
+
+        /// The pool of the given type
+        /*! It is never deleted, because the objects can be freed at any time, even by the
+         *  destructors of the global variables. */
+        template <class T>
+        static inline SlabPool & Get(void)
+        {
+            static SlabPool * pool = new SlabPool(sizeof(T), alignof(T));
+            return *pool;
+        }
+
+        /// The size of the chunks, the large blocks are allocated one by one
+        static constexpr size_t CHUNK_SIZE = 65536;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::SlabPool");
+
+        SlabPool(const SlabPool &) = delete;
+        SlabPool & operator=(const SlabPool &) = delete;
+
+        void AddChunk(void);
+
+        /// A free block
+        struct Block
+        {
+            Block * next;
+
+        }; // struct Glesly::SlabPool::Block
+
+        Threads::Mutex myMutex;
+
+        size_t myBlockSize;
+
+        size_t myBlocksPerChunk;
+
+        Block * myFree;
+
+        std::vector<void *> myChunks;
+
+    }; // class SlabPool
+
+    /// Standard allocator to allocate single objects from a \ref SlabPool
+    /*! It is used with std::allocate_shared(), so the object and the control block of the smart
+     *  pointer are allocated together, in one block of the pool of this combined type.
+     *  \note   The arrays are allocated by the global operator new. */
+    template <class T>
+    class PoolAllocator
+    {
+     public:
+        typedef T value_type;
+
+        inline PoolAllocator(void) noexcept
+        {
+        }
+
+        template <class U>
+        inline PoolAllocator(const PoolAllocator<U> &) noexcept
+        {
+        }
+
+        inline T * allocate(size_t n)
+        {
+            if (n != 1) {
+                return static_cast<T *>(::operator new(n * sizeof(T)));
+            }
+            return static_cast<T *>(SlabPool::Get<T>().Allocate());
+        }
+
+        inline void deallocate(T * p, size_t n) noexcept
+        {
+            if (n != 1) {
+                ::operator delete(p);
+                return;
+            }
+            SlabPool::Get<T>().Free(p);
+        }
+
+        template <class U>
+        inline bool operator==(const PoolAllocator<U> &) const noexcept
+        {
+            return true;
+        }
+
+        template <class U>
+        inline bool operator!=(const PoolAllocator<U> &) const noexcept
+        {
+            return false;
+        }
+
+    }; // class PoolAllocator
+
+    /// Makes the protected constructor of an Object available for the pool allocation
+    /*! \see ObjectBase::Allocate() */
+    template <class T>
+    class PooledObject: public T
+    {
+     public:
+        template <typename... Args>
+        inline PooledObject(Args &&... args):
+            T(std::forward<Args>(args)...)
+        {
+        }
+
+    }; // class PooledObject
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_POOL_ALLOCATOR_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -37,6 +37,9 @@ void Program::ProgramInit(void)
 
  myProgram = glCreateProgram();
 
+ // The new program has the default values:
+ myUniformCache.Reset();
+
  SYS_DEBUG(DL_INFO1, "KGY Created program: " << myProgram);
 
  UseShaders();
@@ -50,6 +53,8 @@ void Program::ProgramCleanup(void)
 
  glDeleteProgram(myProgram);
 
+ myUniformCache.Reset();
+
  SYS_DEBUG(DL_INFO1, "KGY Deleted program: " << myProgram);
 }
 
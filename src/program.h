@@ -84,6 +84,11 @@ namespace Glesly
         virtual GLint GetUniformLocationSafe(const char * name) const;
         GLint GetAttribLocationSafe(const char * name) const;
 
+        virtual Glesly::Shaders::UniformCache * GetUniformCache(void) const override
+        {
+            return &myUniformCache;
+        }
+
         std::string GetLogInfo(void);
 
      protected:
@@ -98,6 +103,9 @@ namespace Glesly
      private:
         SYS_DEFINE_CLASS_NAME("Glesly::Program");
 
+        /// The values of the uniforms of this program (Render Thread only)
+        mutable Glesly::Shaders::UniformCache myUniformCache;
+
     }; // class Program
 
     class UseDepth
@@ -0,0 +1,49 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Change tracking for the render-on-demand mode
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "redraw.h"
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class Redraw:                                                                     *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/// The first frame is always drawn
+std::atomic<bool> Redraw::isDirty(true);
+
+std::atomic<bool> Redraw::isWaiting(false);
+
+std::atomic<bool> Redraw::isFullDamage(true);
+
+std::atomic<uint64_t> Redraw::myDamage(0);
+
+Threads::Semaphore Redraw::myWakeup;
+
+/// Blocks the Render Thread until the next \ref Redraw::Request()
+/*! It may return without request too, so the caller must check \ref Redraw::Take() again. */
+void Redraw::Wait(void)
+{
+ SYS_DEBUG_STATIC(DM_GLESLY);
+
+ isWaiting = true;
+
+ // The flag is checked again, to prevent losing a request between the two flags:
+ if (!isDirty.load()) {
+    SYS_DEBUG(DL_INFO3, "Waiting for redraw request...");
+    myWakeup.Wait();
+ }
+
+ isWaiting = false;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
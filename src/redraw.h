@@ -0,0 +1,103 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Change tracking for the render-on-demand mode
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_REDRAW_H_INCLUDED__
+#define __GLESLY_SRC_REDRAW_H_INCLUDED__
+
+#include <atomic>
+
+#include <glesly/damage.h>
+#include <Threads/Semaphore.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// Notifies the Render Thread that the screen has to be redrawn
+    /*! Every change that affects the rendered image must call \ref Redraw::Request(), from any
+     *  thread. It is done automatically by the object lists, the transformations, the uniforms,
+     *  the callbacks, the layer effects and the input events.<br>
+     *  These changes damage the whole screen. If the changed area is known, it can be passed
+     *  to \ref Redraw::Request(const DamageRect &), see also \ref ObjectBase::Damage().<br>
+     *  It is used only if the render-on-demand mode (\ref Main::SetRenderOnDemand()) or the
+     *  partial redraw (\ref Main::SetPartialRedraw()) is switched on. Otherwise it costs only
+     *  a few atomic operations. */
+    class Redraw
+    {
+     public:
+        /// Marks the whole screen dirty, and wakes up the Render Thread if it is waiting
+        static inline void Request(void)
+        {
+            if (!isFullDamage.load(std::memory_order_relaxed)) {
+                isFullDamage.store(true);
+            }
+            Wakeup();
+        }
+
+        /// Marks a part of the screen dirty
+        /*! It is used by the partial redraw, see \ref Main::SetPartialRedraw().
+         *  \param  area    The damaged area in window coordinates. */
+        static inline void Request(const Glesly::DamageRect & area)
+        {
+            uint64_t previous = myDamage.load(std::memory_order_relaxed);
+            while (!myDamage.compare_exchange_weak(previous, DamageRect::Unpack(previous).Add(area).Pack())) { }
+            Wakeup();
+        }
+
+        /// Takes the dirty flag (Render Thread)
+        /*! \retval true    The screen has to be redrawn.
+         *  \note   The flag is cleared here, so the changes during the frame request the next one. */
+        static inline bool Take(void)
+        {
+            return isDirty.exchange(false);
+        }
+
+        /// Takes the area damaged since the previous call (Render Thread)
+        /*! \param  full    The whole screen, it is returned if the damaged area is not known. */
+        static inline Glesly::DamageRect TakeDamage(const Glesly::DamageRect & full)
+        {
+            DamageRect area = DamageRect::Unpack(myDamage.exchange(0));
+            if (isFullDamage.exchange(false)) {
+                return full;
+            }
+            return area.Clip(full.width, full.height);
+        }
+
+        static void Wait(void);
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::Redraw");
+
+        static inline void Wakeup(void)
+        {
+            if (!isDirty.exchange(true) && isWaiting.load()) {
+                myWakeup.Post();
+            }
+        }
+
+        static std::atomic<bool> isDirty;
+
+        static std::atomic<bool> isFullDamage;
+
+        /// The damaged area, see \ref DamageRect::Pack()
+        static std::atomic<uint64_t> myDamage;
+
+        static std::atomic<bool> isWaiting;
+
+        static Threads::Semaphore myWakeup;
+
+    }; // class Redraw
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_REDRAW_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
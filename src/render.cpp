@@ -11,9 +11,12 @@
 #include "render.h"
 
 #include <glesly/object.h>
+#include <glesly/clock.h>
 
 #include <GLES2/gl2.h>
 
+#include <algorithm>
+
 #include <Memory/Dump.h>
 
 using namespace Glesly;
@@ -27,20 +30,70 @@ using namespace Glesly;
 Render::Render(CameraMatrix & camera, float aspect):
     myScreenAspect(aspect),
     myCameraMatrix(*this, "camera_matrix", camera),
-    objInitList(nullptr),
-    freeObjIniters(nullptr)
+    isLateLatch(false),
+    isDrawBuckets(false),
+    myBucketVersion(0),
+    myInterpolation(1.0f),
+    myNextInterpolation(1.0f),
+    myStateGeneration(0),
+    myReadGeneration(0),
+    myCommitGeneration(0),
+    myCommitRead(0),
+    myFrameGeneration(0),
+    myDirtyObjects(nullptr),
+    myRetired(nullptr),
+    myTimerMode(TIMER_MODE_ALL),
+    myTimerRequests(nullptr),
+    myCallbackBudget(DEFAULT_CALLBACK_BUDGET),
+    myInitRequests(nullptr),
+    myGLRequests(0),
+    myInitSequence(0),
+    myInitTimeBudget(0),
+    myInitUploadBudget(0)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
- for (objectIniter * oi = initers; oi < initers + initerSize; ++oi) {
-    oi->next = freeObjIniters;
-    freeObjIniters = oi;
+ for (int i = 0; i < ObjectBase::CALLBACK_PRIORITIES; ++i) {
+    myCallbackRequests[i] = nullptr;
+    myCallbackFirst[i] = nullptr;
+    myCallbackLast[i] = nullptr;
  }
+
+ myTimerWheel.Reset(TimerWheel::ToTick(Clock::Now()));
 }
 
 Render::~Render()
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ InitRequest * request = myInitRequests.exchange(nullptr);
+ while (request) {
+    InitRequest * next = request->next;
+    delete request;
+    request = next;
+ }
+
+ TimerRequest * timer = myTimerRequests.exchange(nullptr);
+ while (timer) {
+    TimerRequest * next = timer->next;
+    delete timer;
+    timer = next;
+ }
+
+ for (int i = 0; i < ObjectBase::CALLBACK_PRIORITIES; ++i) {
+    ObjectBase * obj = myCallbackRequests[i].exchange(nullptr);
+    while (obj) {
+        ObjectBase * next = obj->myCallbackNext[i];
+        obj->myCallbackSelf[i].reset();
+        obj = next;
+    }
+    obj = myCallbackFirst[i];
+    while (obj) {
+        ObjectBase * next = obj->myCallbackNext[i];
+        obj->myCallbackSelf[i].reset();
+        obj = next;
+    }
+ }
 }
 
 void Render::Cleanup(void)
@@ -49,69 +102,235 @@ void Render::Cleanup(void)
 
  ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
  if (p) {
-    for (ObjectListIterator i = p->begin(); i != p->end(); ++i) {
+    Objects::Reader objects(*p);
+    for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+        (*i)->isGLInitialized = false;
         (*i)->uninitGL();
     }
  }
 
+ DropRetiredObjects();
+
  GetObjectList().Cleanup();
 }
 
+/// Requests the GL initialization of an Object (any thread)
+/*! The request is put on a lock-free stack, the Render Thread takes it at the next frame, see
+ *  \ref Render::InitPendingObjects(). */
 void Render::InitGLObject(ObjectWeak & object)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
- Threads::Lock _l(myObjInitMutex);
+ myGLRequests.fetch_add(1, std::memory_order_relaxed);
 
- objectIniter * oi = freeObjIniters;
-
- ASSERT(oi, "too few Object Initializers allocated");
- SYS_DEBUG(DL_INFO3, "ObjIniter: " << oi << ", next: " << oi->next);
+ for (InitBatch * batch = InitBatch::myActual; batch; batch = batch->myPrevious) {
+    if (&batch->myRender == this) {
+        batch->myObjects.push_back(object);
+        return;
+    }
+ }
 
- freeObjIniters = oi->next; // get it from the free list
+ InitRequest * request = new InitRequest;
+ request->object = object;
 
- oi->object = object;       // assign the object
+ PushInitRequests(request, request);
 
- oi->next = objInitList;    // put it in the initializer list
- objInitList = oi;
+ Redraw::Request();
 }
 
-ObjectPtr Render::GetObject2Init(void)
+/// Registers several Objects for GL initialization at once
+/*! \see Render::InitBatch */
+void Render::InitGLObjects(const ObjectWeak * first, const ObjectWeak * last)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
- Threads::Lock _l(myObjInitMutex);
+ if (first == last) {
+    return;
+ }
 
- ObjectPtr op;
+ SYS_DEBUG(DL_INFO2, "Registering " << (last - first) << " objects");
+
+ // Build the chain in reverse order, as if the requests were pushed one by one:
+ InitRequest * top = nullptr;
+ InitRequest * bottom = nullptr;
+ for (; first != last; ++first) {
+    InitRequest * request = new InitRequest;
+    request->object = *first;
+    request->next = top;
+    top = request;
+    if (!bottom) {
+        bottom = request;
+    }
+ }
+
+ PushInitRequests(top, bottom);
+
+ Redraw::Request();
+}
 
+/// Puts a chain of requests on the top of the stack at once
+/*! \param  top     The first element of the chain.
+ *  \param  bottom  The last element of the chain, its 'next' pointer is overwritten. */
+void Render::PushInitRequests(InitRequest * top, InitRequest * bottom)
+{
+ InitRequest * head = myInitRequests.load(std::memory_order_relaxed);
  do {
-    objectIniter * oi = objInitList;
+    bottom->next = head;
+ } while (!myInitRequests.compare_exchange_weak(head, top, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/// Moves the new requests to the queue of pending initializations (Render Thread)
+/*! The stack is taken at once and reversed, so the equal Objects are initialized in the order
+ *  of their requests. The priority of the Objects is evaluated here:
+ *  - the class of \ref ObjectBase::GetInitPriority() comes first,
+ *  - then the cost: the distance from the camera, weighted by the size of the upload, so the
+ *    near and small Objects go first. */
+void Render::CollectInitRequests(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ InitRequest * request = myInitRequests.exchange(nullptr, std::memory_order_acquire);
+
+ InitRequest * reversed = nullptr;
+ while (request) {
+    InitRequest * next = request->next;
+    request->next = reversed;
+    reversed = request;
+    request = next;
+ }
+
+ while (reversed) {
+    InitRequest * next = reversed->next;
+    ObjectPtr obj = reversed->object.lock();
+    if (obj) {
+        PendingInit pending;
+        pending.object = reversed->object;
+        pending.priority = obj->GetInitPriority();
+        pending.cost = (1.0f + obj->GetCameraDistance()) * (1.0f + (float)obj->GetUploadSize() / UPLOAD_COST_UNIT);
+        pending.sequence = myInitSequence++;
+        myPendingInits.push(pending);
+    } else {
+        myGLRequests.fetch_sub(1, std::memory_order_release);
+    }
+    delete reversed;
+    reversed = next;
+ }
+}
 
-    if (!oi) {
-        return ObjectPtr();
+/// Initializes the pending Objects within the budget (Render Thread)
+/*! At least one Object is initialized in each frame, the rest is left for the next frames.
+ *  \see Render::SetInitBudget() */
+void Render::InitPendingObjects(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ CollectInitRequests();
+
+ if (myPendingInits.empty()) {
+    return;
+ }
+
+ int64_t start = Clock::Now();
+ size_t uploaded = 0;
+ unsigned count = 0;
+
+ while (!myPendingInits.empty()) {
+    if (count) {
+        if (myInitTimeBudget && Clock::Now() - start >= myInitTimeBudget) {
+            break;
+        }
+        if (myInitUploadBudget && uploaded >= myInitUploadBudget) {
+            break;
+        }
     }
 
-    objInitList = oi->next;
+    // The object may have been deleted meanwhile:
+    ObjectPtr obj = myPendingInits.top().object.lock();
+    myPendingInits.pop();
+    if (!obj) {
+        myGLRequests.fetch_sub(1, std::memory_order_release);
+        continue;
+    }
 
-    oi->next = freeObjIniters;
-    freeObjIniters = oi;
+    obj->isGLInitialized = false;
+    obj->uninitGL();
+    obj->initGL();
+    obj->isGLInitialized = true;
+    obj->isEvicted = false;
 
-    // Try to get the referenced object:
-    op = oi->object.lock();
+    obj->myGLRequests.fetch_sub(1, std::memory_order_release);
+    myGLRequests.fetch_sub(1, std::memory_order_release);
 
-    // The object referenced by this entry may have been deleted: try the next one in this case.
+    uploaded += obj->GetUploadSize();
+    ++count;
+ }
 
- } while (!op);
+ SYS_DEBUG(DL_INFO2, "Initialized " << count << " objects (" << uploaded << " bytes), " << myPendingInits.size() << " left");
 
- return op;
+ if (!myPendingInits.empty()) {
+    // Continue in the next frame, even in render-on-demand mode:
+    Redraw::Request();
+ }
+}
+
+/// Puts the Object on the retire stack
+/*! It is called by \ref ObjectBase::UnuseGL(), from any thread. The stack keeps a reference of
+ *  the Object until the Render Thread drops it. */
+void Render::Retire(ObjectBase & object)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ object.myRetireSelf = object.mySelf.lock();
+ if (!object.myRetireSelf) {
+    // It is being deleted, so it is not in any list:
+    object.toBeDeleted = false;
+    return;
+ }
+
+ ObjectBase * head = myRetired.load(std::memory_order_relaxed);
+ do {
+    object.myRetireNext = head;
+ } while (!myRetired.compare_exchange_weak(head, &object, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/// Drops the Objects retired since the previous frame (Render Thread)
+/*! The cost depends only on the number of the retired Objects. They have already been removed
+ *  from their stores by \ref ObjectBase::UnuseGL(), so the Render Thread only releases their
+ *  GL resources and its own references, without any lock. The stores release their references
+ *  when the grace period of the removal has passed, see \ref ObjectStore::ReclaimAll(). */
+void Render::DropRetiredObjects(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ObjectBase * next;
+
+ for (ObjectBase * obj = myRetired.exchange(nullptr, std::memory_order_acquire); obj; obj = next) {
+    next = obj->myRetireNext;
+    SYS_DEBUG(DL_INFO2, "Dropping object " << obj);
+    obj->isGLInitialized = false;
+    obj->uninitGL();
+    obj->toBeDeleted = false;
+    // It may delete the object:
+    ObjectPtr self;
+    self.swap(obj->myRetireSelf);
+ }
 }
 
 void Render::NextFrame(const SYS::TimeDelay & frame_start_time)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
+ myStatistics.Start();
+
+ myInterpolation = myNextInterpolation.load(std::memory_order_relaxed);
+
+ // Take the states committed by the last timer pass:
+ PublishPass();
+
  BeforeFrame();
 
+ myStatistics.Mark(FrameStatistics::PHASE_BEFORE_FRAME);
+
  UseProgram();
 
  InitGLVariables();
@@ -119,51 +338,381 @@ void Render::NextFrame(const SYS::TimeDelay & frame_start_time)
 
  Frame(frame_start_time);
 
- for (;;) {
-    ObjectPtr obj = GetObject2Init();
-    if (!obj) {
-        break;
-    }
-    obj->uninitGL();
-    obj->initGL();
- }
+ myStatistics.Mark(FrameStatistics::PHASE_SETUP);
+
+ // The dropped objects first, because they may be reinitialized below:
+ DropRetiredObjects();
+
+ InitPendingObjects();
+
+ // The incoming layer can be started as soon as its Objects have been initialized:
+ CheckNextLayer(*this);
+
+ myStatistics.Mark(FrameStatistics::PHASE_OBJECT_INIT);
+
+ RunCallbacks();
+
+ myStatistics.Mark(FrameStatistics::PHASE_CALLBACKS);
 
  ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
 
  if (p) {
-    for (ObjectListIterator i = p->begin(); i != p->end(); ) {
-        ObjectListIterator j = i++;
-        ObjectPtr obj = *j;
-
-        if (obj->toBeDeleted) {
-            p->erase(j);
-            obj->uninitGL();
-            obj->toBeDeleted = false;
-        } else {
-            obj->DrawFrame(frame_start_time);
-        }
+    Objects::Reader objects(*p);
+    if (isDrawBuckets) {
+        DrawBuckets(objects, frame_start_time);
+    } else {
+        DrawObjects(objects, frame_start_time);
     }
  }
 
+ myStatistics.Mark(FrameStatistics::PHASE_DRAW);
+
  UnuseProgram();
 
  AfterFrame();
+
+ myStatistics.Mark(FrameStatistics::PHASE_AFTER_FRAME);
+ myStatistics.Finish();
+}
+
+/// Draws the Objects in their order
+void Render::DrawObjects(const Objects::Reader & objects, const SYS::TimeDelay & frame_start_time)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    ObjectBase * obj = *i;
+    if (PrepareDraw(*obj)) {
+        obj->DrawFrame(frame_start_time);
+    }
+ }
+}
+
+/// Draws the Objects grouped by their types
+/*! \see Render::SetDrawBuckets() */
+void Render::DrawBuckets(const Objects::Reader & objects, const SYS::TimeDelay & frame_start_time)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ // The buckets are valid while the Reader keeps the same array:
+ if (objects.GetVersion() != myBucketVersion) {
+    FillBuckets(objects);
+ }
+
+ for (std::vector<DrawType>::iterator i = myDrawTypes.begin(); i != myDrawTypes.end(); ++i) {
+    if (!i->objects.empty()) {
+        i->draw(*this, i->objects.data(), i->objects.size(), frame_start_time);
+    }
+ }
+
+ for (std::vector<ObjectBase *>::iterator i = myUnbucketed.begin(); i != myUnbucketed.end(); ++i) {
+    if (PrepareDraw(**i)) {
+        (*i)->DrawFrame(frame_start_time);
+    }
+ }
+}
+
+/// Sorts the Objects into the buckets of their types
+/*! The vectors keep their capacity, so it does not allocate in a steady state. */
+void Render::FillBuckets(const Objects::Reader & objects)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ for (std::vector<DrawType>::iterator i = myDrawTypes.begin(); i != myDrawTypes.end(); ++i) {
+    i->objects.clear();
+ }
+ myUnbucketed.clear();
+
+ for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
+    const std::type_info & type = typeid(**i);
+    std::vector<DrawType>::iterator bucket = myDrawTypes.begin();
+    while (bucket != myDrawTypes.end() && *bucket->type != type && *bucket->pooled != type) {
+        ++bucket;
+    }
+    if (bucket != myDrawTypes.end()) {
+        bucket->objects.push_back(*i);
+    } else {
+        myUnbucketed.push_back(*i);
+    }
+ }
+
+ myBucketVersion = objects.GetVersion();
+
+ SYS_DEBUG(DL_INFO2, "Filled " << myDrawTypes.size() << " buckets, " << myUnbucketed.size() << " objects are not bucketed");
+}
+
+/// Uploads the uniforms again if new states have been committed since the start of the frame
+/*! \see Render::SetLateLatch() */
+void Render::LatchVariables(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ // The Objects have taken their states already, so the newer pass can be announced:
+ if (PublishStates(AnnouncePass())) {
+    SYS_DEBUG(DL_INFO3, "Late latch: new state is used");
+    ActivateVariables();
+ }
 }
 
 void Render::Timer(void)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 
- ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
+ if (myTimerMode == TIMER_MODE_REGISTERED) {
+    CollectDueTimers();
+    DispatchTimers(myTimerObjects.data(), myTimerObjects.size());
+    CommitPass(myTimerObjects.data(), myTimerObjects.size());
+    for (std::vector<ObjectBase *>::const_iterator i = myTimerObjects.begin(); i != myTimerObjects.end(); ++i) {
+        (*i)->myTimerSelf.reset();
+    }
+    myTimerObjects.clear();
+ } else {
+    // The registrations wait for TIMER_MODE_REGISTERED, the wheel is not needed here:
+    ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
+    if (p) {
+        Objects::Reader objects(*p);
+        DispatchTimers(objects.begin(), objects.size());
+        CommitPass(objects.begin(), objects.size());
+    } else {
+        CommitPass(nullptr, 0);
+    }
+ }
+}
 
- if (p) {
-    for (ObjectListIterator i = p->begin(); i != p->end(); ++i) {
-        ObjectPtr obj = *i;
+/// Commits the states of the timer pass as one generation (Timer Thread)
+/*! The states of the Render (e.g. the camera) are also committed here. The pass is finished by
+ *  one atomic store, the Render Thread takes the states of the last finished pass only, so a
+ *  frame never sees a half-committed pass, and neither thread waits for the other.
+ *  \see Render::PublishPass() */
+void Render::CommitPass(ObjectBase * const * objects, size_t count)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
 
-        if (!obj->toBeDeleted) {
-            obj->Timer();
+ myCommitGeneration = myStateGeneration.load(std::memory_order_relaxed) + 1;
+ myCommitRead = myReadGeneration.load();
+
+ for (ObjectBase * const * i = objects; i != objects + count; ++i) {
+    (*i)->CommitFrameStates(*this);
+ }
+
+ CommitStates(myCommitGeneration, myCommitRead);
+
+ myStateGeneration.store(myCommitGeneration);
+}
+
+/// Commits the states of one Object in the actual pass (Timer Thread)
+/*! It is called by \ref ObjectBase::CommitFrameStates(). If anything has been committed, the
+ *  Object is put on the dirty stack, so the Render Thread publishes only these Objects. */
+void Render::CommitObject(ObjectBase & object)
+{
+ if (!object.CommitStates(myCommitGeneration, myCommitRead)) {
+    return;
+ }
+
+ object.myCommitPass.store(myCommitGeneration);
+
+ if (object.isStateDirty.exchange(true)) {
+    // It is on the stack or in the published list already:
+    return;
+ }
+
+ object.myDirtySelf = object.mySelf.lock();
+ if (!object.myDirtySelf) {
+    // It is being deleted:
+    return;
+ }
+
+ ObjectBase * head = myDirtyObjects.load(std::memory_order_relaxed);
+ do {
+    object.myDirtyNext = head;
+ } while (!myDirtyObjects.compare_exchange_weak(head, &object, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/// Announces the last finished timer pass to the Timer Thread (Render Thread)
+/*! The Timer Thread does not overwrite the states of the announced pass, see
+ *  \ref StateBuffer::Commit(). The pass is read again, so the announcement cannot be missed
+ *  by a pass finished meanwhile. */
+uint64_t Render::AnnouncePass(void)
+{
+ uint64_t pass;
+
+ do {
+    pass = myStateGeneration.load();
+    myReadGeneration.store(pass);
+ } while (myStateGeneration.load() != pass);
+
+ return pass;
+}
+
+/// Publishes the last finished timer pass for the actual frame (Render Thread)
+/*! All of the states are taken at once, before drawing. Only the Objects committed since the
+ *  previous frame are published, and the ones still being blended (see
+ *  \ref InterpolatedState). Only the late latch (see \ref Render::SetLateLatch()) takes the
+ *  states of the Render later. */
+void Render::PublishPass(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myFrameGeneration = AnnouncePass();
+
+ PublishStates(myFrameGeneration);
+
+ // Take the Objects committed since the previous frame:
+ for (ObjectBase * obj = myDirtyObjects.exchange(nullptr, std::memory_order_acquire); obj; obj = obj->myDirtyNext) {
+    myPublishedObjects.push_back(ObjectPtr());
+    myPublishedObjects.back().swap(obj->myDirtySelf);
+ }
+
+ size_t kept = 0;
+
+ for (size_t i = 0; i < myPublishedObjects.size(); ++i) {
+    ObjectBase & obj = *myPublishedObjects[i];
+    if (!obj.PublishStates(myFrameGeneration) && obj.myCommitPass.load() <= myFrameGeneration) {
+        obj.isStateDirty.store(false);
+        // Committed again meanwhile, but the Timer Thread may have found the flag still set:
+        if (obj.myCommitPass.load() <= myFrameGeneration || obj.isStateDirty.exchange(true)) {
+            continue;
+        }
+    }
+    if (kept != i) {
+        myPublishedObjects[kept].swap(myPublishedObjects[i]);
+    }
+    ++kept;
+ }
+
+ // The Objects not kept are released here:
+ myPublishedObjects.resize(kept);
+
+ SYS_DEBUG(DL_INFO3, "Pass " << myFrameGeneration << ": " << kept << " objects are still being published");
+}
+
+/// Registers the timer of an Object (any thread)
+/*! It is called by \ref ObjectBase::SetTimerPeriod(), the registration is taken by the Timer
+ *  Thread at the next \ref Render::Timer(). The requests come from a pool, so the frequent
+ *  registrations do not use the heap. */
+void Render::RegisterTimer(const ObjectWeak & object, uint32_t generation, int64_t period, bool once)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ TimerRequest * request = new TimerRequest;
+ request->object = object;
+ request->generation = generation;
+ request->period = period;
+ request->once = once;
+ request->time = Clock::Now();
+
+ TimerRequest * head = myTimerRequests.load(std::memory_order_relaxed);
+ do {
+    request->next = head;
+ } while (!myTimerRequests.compare_exchange_weak(head, request, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/// Puts the new registrations into the timer wheel (Timer Thread)
+void Render::TakeTimerRequests(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ TimerRequest * request = myTimerRequests.exchange(nullptr, std::memory_order_acquire);
+
+ while (request) {
+    ObjectPtr obj = request->object.lock();
+    // The registrations replaced meanwhile are dropped:
+    if (obj && request->generation == obj->myTimerGeneration.load()) {
+        TimerWheel::Entry entry;
+        entry.object = request->object;
+        entry.generation = request->generation;
+        if (request->period == ObjectBase::TIMER_EVERY_FRAME && !request->once) {
+            entry.period = 0;
+            entry.due = 0;
+            myFrameTimers.push_back(entry);
+        } else {
+            entry.period = request->once ? 0 : std::max(TimerWheel::ToTick(request->period), (uint64_t)1);
+            entry.due = TimerWheel::ToTick(request->time + request->period);
+            myTimerWheel.Add(entry);
         }
     }
+    TimerRequest * next = request->next;
+    delete request;
+    request = next;
+ }
+}
+
+/// Collects the Objects of the expired timers into \ref Render::myTimerObjects (Timer Thread)
+/*! The periodic timers are rescheduled, the cancelled ones are dropped here. The Objects are
+ *  kept alive by their \ref ObjectBase::myTimerSelf until the end of the pass. */
+void Render::CollectDueTimers(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ TakeTimerRequests();
+
+ size_t kept = 0;
+ for (size_t i = 0; i < myFrameTimers.size(); ++i) {
+    ObjectPtr obj = myFrameTimers[i].object.lock();
+    if (obj && myFrameTimers[i].generation == obj->myTimerGeneration.load()) {
+        myFrameTimers[kept++] = myFrameTimers[i];
+        myTimerObjects.push_back(obj.get());
+        obj->myTimerSelf.swap(obj); // The reference is moved, not copied
+    }
+ }
+ myFrameTimers.resize(kept);
+
+ uint64_t tick = TimerWheel::ToTick(Clock::Now());
+
+ myTimerWheel.Advance(tick, myDueTimers);
+
+ for (std::vector<TimerWheel::Entry>::iterator i = myDueTimers.begin(); i != myDueTimers.end(); ++i) {
+    ObjectPtr obj = i->object.lock();
+    if (!obj || i->generation != obj->myTimerGeneration.load()) {
+        continue;
+    }
+    myTimerObjects.push_back(obj.get());
+    obj->myTimerSelf.swap(obj);
+    if (i->period) {
+        // Skip the periods missed, instead of calling the timer several times:
+        i->due += i->period;
+        if (i->due <= tick) {
+            i->due = tick + i->period;
+        }
+        myTimerWheel.Add(*i);
+    }
+ }
+
+ myDueTimers.clear();
+}
+
+/// Calls the timers of the Objects, using \ref Render::myTimerPool if it is set (Timer Thread)
+/*! The states are committed later, together, see \ref Render::CommitPass(). */
+void Render::DispatchTimers(ObjectBase * const * objects, size_t count)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ObjectBase * const * end = objects + count;
+
+ TimerPoolPtr pool = myTimerPool;
+
+ if (pool) {
+    // The caller keeps the objects alive while the pool is running:
+    myParallelTimers.clear();
+    for (ObjectBase * const * i = objects; i != end; ++i) {
+        ObjectBase * obj = *i;
+        if (!obj->toBeDeleted && obj->IsTimerThreadSafe()) {
+            myParallelTimers.push_back(obj);
+        }
+    }
+    pool->Start(myParallelTimers.data(), myParallelTimers.size());
+ }
+
+ for (ObjectBase * const * i = objects; i != end; ++i) {
+    ObjectBase * obj = *i;
+
+    if (!obj->toBeDeleted && (!pool || !obj->IsTimerThreadSafe())) {
+        obj->Timer();
+    }
+ }
+
+ if (pool) {
+    pool->Finish();
  }
 }
 
@@ -190,8 +739,9 @@ void Render::MouseClickRaw(int x, int y, int index, int count)
  ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
 
  if (p) {
-    SYS_DEBUG(DL_INFO2, "Having " << p->size() << " objects");
-    for (ObjectListIterator i = p->begin(); i != p->end(); ++i) {
+    Objects::Reader objects(*p);
+    SYS_DEBUG(DL_INFO2, "Having " << objects.size() << " objects");
+    for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
        if ((*i)->MouseClick(horiz, vert, index, count)) {
            break;
        }
@@ -210,16 +760,149 @@ void Render::KeyboardClick(UTF8::WChar key)
  ObjectListPtr p = GetObjectListPtr(); // The pointer is copied here to solve thread safety
 
  if (p) {
-    SYS_DEBUG(DL_INFO2, "Having " << p->size() << " objects");
-    for (ObjectListIterator i = p->begin(); i != p->end(); ++i) {
+    Objects::Reader objects(*p);
+    SYS_DEBUG(DL_INFO2, "Having " << objects.size() << " objects");
+    for (ObjectListIterator i = objects.begin(); i != objects.end(); ++i) {
        (*i)->KeyboardClick(key);
     }
  }
 }
 
-int Render::GetCallbackTimeLimit(void) const
+/// Registers an Object having new callbacks (any thread)
+/*! It is called by \ref ObjectBase::Execute(), once until the Object has callbacks. The
+ *  Object is kept alive until the Render Thread takes it. */
+void Render::ScheduleCallbacks(ObjectBase & object, ObjectBase::CallbackPriority priority)
 {
- return 30; // TODO: be configurable!
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ object.myCallbackSelf[priority] = object.mySelf.lock();
+ if (!object.myCallbackSelf[priority]) {
+    return; // it is being deleted
+ }
+
+ ObjectBase * head = myCallbackRequests[priority].load(std::memory_order_relaxed);
+ do {
+    object.myCallbackNext[priority] = head;
+ } while (!myCallbackRequests[priority].compare_exchange_weak(head, &object, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/// Executes the callbacks of the Objects within the budget (Render Thread)
+/*! Each Object in the queue executes its callbacks once, then it is put at the end of the
+ *  queue if it still has callbacks. The Objects put back are not served again in the same frame.
+ *  The Objects held by the queue only are dropped without executing their callbacks.
+ *  \see Render::SetCallbackBudget() */
+void Render::RunCallbacks(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ int64_t start = Clock::Now();
+ unsigned count = 0;
+ bool pending = false;
+
+ for (int priority = 0; priority < ObjectBase::CALLBACK_PRIORITIES; ++priority) {
+    ObjectBase *& first = myCallbackFirst[priority];
+    ObjectBase *& last = myCallbackLast[priority];
+
+    // Append the new ones, in the order of their arrival:
+    ObjectBase * request = myCallbackRequests[priority].exchange(nullptr, std::memory_order_acquire);
+    ObjectBase * reversed = nullptr;
+    while (request) {
+        ObjectBase * next = request->myCallbackNext[priority];
+        request->myCallbackNext[priority] = reversed;
+        reversed = request;
+        request = next;
+    }
+    if (reversed) {
+        if (last) {
+            last->myCallbackNext[priority] = reversed;
+        } else {
+            first = reversed;
+        }
+        for (last = reversed; last->myCallbackNext[priority]; last = last->myCallbackNext[priority]) { }
+    }
+
+    // The lower priorities having callbacks keep their share of the budget:
+    int64_t budget = myCallbackBudget;
+    for (int lower = priority + 1; lower < ObjectBase::CALLBACK_PRIORITIES; ++lower) {
+        if (myCallbackFirst[lower] || myCallbackRequests[lower].load(std::memory_order_relaxed)) {
+            budget -= myCallbackBudget / CALLBACK_MIN_SHARE;
+        }
+    }
+
+    // The Objects put back after this one are served in the next frame:
+    ObjectBase * stop = last;
+    unsigned served = 0;
+    while (first) {
+        if (served && myCallbackBudget && Clock::Now() - start >= budget) {
+            break;
+        }
+        ObjectBase * obj = first;
+        first = obj->myCallbackNext[priority];
+        if (!first) {
+            last = nullptr;
+        }
+        obj->myCallbackNext[priority] = nullptr;
+        ++served;
+
+        // The Object can be scheduled again as soon as its callbacks are done, so the
+        // reference is moved out before running them:
+        ObjectPtr self;
+        self.swap(obj->myCallbackSelf[priority]);
+        if (self.use_count() > 1 && obj->RunCallbacks((ObjectBase::CallbackPriority)priority)) {
+            obj->myCallbackSelf[priority].swap(self);
+            if (last) {
+                last->myCallbackNext[priority] = obj;
+            } else {
+                first = obj;
+            }
+            last = obj;
+        }
+
+        if (obj == stop) {
+            break;
+        }
+    }
+    count += served;
+
+    if (first) {
+        pending = true;
+    }
+ }
+
+ if (count) {
+    SYS_DEBUG(DL_INFO2, "Callbacks of " << count << " objects executed");
+ }
+
+ if (pending) {
+    // Continue in the next frame:
+    Redraw::Request();
+ }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *       Class Render::InitBatch:                                                        *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+thread_local Render::InitBatch * Render::InitBatch::myActual = nullptr;
+
+Render::InitBatch::InitBatch(Render & render):
+    myRender(render),
+    myPrevious(myActual)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myActual = this;
+}
+
+Render::InitBatch::~InitBatch()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myActual = myPrevious;
+
+ myRender.InitGLObjects(myObjects.data(), myObjects.data() + myObjects.size());
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
@@ -234,7 +917,8 @@ Render3D::Render3D(RenderInfo & renderInfo):
     myT1Matrix(*this, "t0_matrix", renderInfo.myTransform[0]),
     myT2Matrix(*this, "t1_matrix", renderInfo.myTransform[1]),
     myT3Matrix(*this, "t2_matrix", renderInfo.myTransform[2]),
-    myT4Matrix(*this, "t3_matrix", renderInfo.myTransform[3])
+    myT4Matrix(*this, "t3_matrix", renderInfo.myTransform[3]),
+    myNextRenderInfo(*this, renderInfo)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
 }
@@ -12,20 +12,28 @@
 #define __GLESLY_SRC_RENDER_H_INCLUDED__
 
 #include <list>
+#include <queue>
+#include <vector>
+#include <atomic>
+#include <typeinfo>
 
 #include <glesly/camera.h>
 #include <glesly/program.h>
 #include <glesly/object-list+effect.h>
 #include <glesly/render-ptr.h>
 #include <glesly/object-ptr.h>
+#include <glesly/object-base.h>
 #include <glesly/shader-uniforms.h>
+#include <glesly/frame-statistics.h>
+#include <glesly/state-buffer.h>
+#include <glesly/timer-pool.h>
+#include <glesly/timer-wheel.h>
 #include <International/utf8.h>
-#include <Threads/Mutex.h>
 
 namespace Glesly
 {
     /// An OpenGL program with Objects
-    class Render: public Glesly::Program, public Glesly::ObjectsWithEffect
+    class Render: public Glesly::Program, public Glesly::ObjectsWithEffect, public Glesly::StateManager
     {
      public:
         virtual ~Render();
@@ -57,8 +65,233 @@ namespace Glesly
             return myScreenAspect;
         }
 
-        int GetCallbackTimeLimit(void) const;
+        void ScheduleCallbacks(Glesly::ObjectBase & object, Glesly::ObjectBase::CallbackPriority priority);
+        void RegisterTimer(const Glesly::ObjectWeak & object, uint32_t generation, int64_t period, bool once);
+        void Retire(Glesly::ObjectBase & object);
+        void CommitObject(Glesly::ObjectBase & object);
         void InitGLObject(Glesly::ObjectWeak & object);
+        void InitGLObjects(const Glesly::ObjectWeak * first, const Glesly::ObjectWeak * last);
+
+        /// Tells if any GL initialization of the Objects of this Render is not done yet
+        /*! The requests are counted like the ones of the individual Objects, see
+         *  \ref ObjectBase::IsGLPending().
+         *  \see ObjectsWithEffect::CheckNextLayer() */
+        inline bool IsGLPending(void) const
+        {
+            return myGLRequests.load(std::memory_order_acquire) != 0;
+        }
+
+        /// Collects the GL initialization requests of the calling thread
+        /*! While it exists, the requests of the Objects of this Render made by the calling
+         *  thread (e.g. by \ref ObjectBase::Create()) are collected, and they are passed to the
+         *  Render Thread at once by the destructor. It is useful when a lot of Objects are
+         *  created together, see \ref ObjectList.
+         *  \note   The batches can be nested. */
+        class InitBatch
+        {
+            friend class Render;
+
+         public:
+            InitBatch(Glesly::Render & render);
+            ~InitBatch();
+
+         private:
+            SYS_DEFINE_CLASS_NAME("Glesly::Render::InitBatch");
+
+            Glesly::Render & myRender;
+
+            /// The enclosing batch of the same thread
+            InitBatch * myPrevious;
+
+            std::vector<Glesly::ObjectWeak> myObjects;
+
+            static thread_local InitBatch * myActual;
+
+        }; // class Glesly::Render::InitBatch
+
+        /// Sets the worker pool to execute the thread-safe Object timers
+        /*! If it is set, the timers of the Objects marked by \ref ObjectBase::IsTimerThreadSafe()
+         *  are executed by the pool, the others are executed by the Timer Thread meanwhile.
+         *  \param  pool    The worker pool, or an empty pointer to execute all of the timers
+         *                  in the Timer Thread. */
+        inline void SetTimerPool(const Glesly::TimerPoolPtr & pool)
+        {
+            myTimerPool = pool;
+        }
+
+        inline const Glesly::TimerPoolPtr & GetTimerPool(void) const
+        {
+            return myTimerPool;
+        }
+
+        /// The ways of calling the timers of the Objects, see \ref Render::SetTimerMode()
+        enum TimerMode
+        {
+            TIMER_MODE_ALL = 0,         ///< The timer of each Object is called after each frame
+            TIMER_MODE_REGISTERED       ///< Only the registered timers are called
+
+        }; // enum Glesly::Render::TimerMode
+
+        /// Selects which timers are called by \ref Render::Timer()
+        /*! In \ref Render::TIMER_MODE_ALL (the default) the function \ref ObjectBase::Timer() of
+         *  each Object is called after each frame.<br>
+         *  In \ref Render::TIMER_MODE_REGISTERED only the Objects registered by
+         *  \ref ObjectBase::SetTimerPeriod() or \ref ObjectBase::SetTimerOnce() are called, when
+         *  their timers expire. The cost depends on the number of the expired timers only.
+         *  \note   The registrations are kept, but not processed in \ref Render::TIMER_MODE_ALL. */
+        inline void SetTimerMode(TimerMode mode)
+        {
+            myTimerMode = mode;
+        }
+
+        inline TimerMode GetTimerMode(void) const
+        {
+            return myTimerMode;
+        }
+
+        /// Limits the time of the callbacks in one frame
+        /*! The limit is common for all Objects: the Objects having callbacks are served in
+         *  round-robin order, the high priority ones first, while the time is not over. The rest
+         *  is continued in the next frame, starting with the Objects not served in this frame.
+         *  The lower priorities are not starved: while they have callbacks, each of them keeps
+         *  1/\ref Render::CALLBACK_MIN_SHARE of the budget from the higher ones, and at least one
+         *  Object of each priority is served in each frame.
+         *  \param  time_limit      In nanoseconds, 0 means no limit.
+         *  \see ObjectBase::Execute() */
+        inline void SetCallbackBudget(int64_t time_limit)
+        {
+            myCallbackBudget = time_limit;
+        }
+
+        inline int64_t GetCallbackBudget(void) const
+        {
+            return myCallbackBudget;
+        }
+
+        /// The callback budget in milliseconds
+        /*! \deprecated    Use \ref Render::GetCallbackBudget() instead. */
+        inline int GetCallbackTimeLimit(void) const
+        {
+            return (int)(myCallbackBudget / 1000000LL);
+        }
+
+        /// The lower priority callbacks keep 1/N of the budget each, see \ref Render::SetCallbackBudget()
+        static constexpr int64_t CALLBACK_MIN_SHARE = 4;
+
+        /// Limits the GL initialization of the Objects in one frame
+        /*! The Objects are initialized in the order of their priority (see
+         *  \ref ObjectBase::GetInitPriority()), while the limits are not reached; the rest is
+         *  left for the next frames. At least one Object is initialized in
+         *  each frame, so the queue is always progressing. It avoids long frames after creating
+         *  a lot of Objects at once.
+         *  \param  time_limit      The time spent on initialization in one frame, in nanoseconds,
+         *                          or 0 for no limit.
+         *  \param  upload_limit    The amount of data uploaded in one frame in bytes, or 0 for no
+         *                          limit, see \ref ObjectBase::GetUploadSize(). */
+        inline void SetInitBudget(int64_t time_limit, size_t upload_limit = 0)
+        {
+            myInitTimeBudget = time_limit;
+            myInitUploadBudget = upload_limit;
+        }
+
+        /// Draws the Objects grouped by their types
+        /*! In this mode the Objects of each type registered by \ref Render::RegisterDrawType()
+         *  are drawn by a loop of their own, in the order of the registration, and the
+         *  other Objects are drawn after them. It reduces the virtual calls and the
+         *  mispredicted branches in the draw loop. The cost depends on the number of types,
+         *  not on the number of Objects. The buckets are rebuilt only when the list of the
+         *  Objects changes.
+         *  \note   The drawing order of the Objects of different types is changed, so it is
+         *          suitable only if it does not matter, e.g. the depth test is used. The
+         *          Objects of the same type keep their order. */
+        inline void SetDrawBuckets(bool enable = true)
+        {
+            isDrawBuckets = enable;
+        }
+
+        inline bool IsDrawBuckets(void) const
+        {
+            return isDrawBuckets;
+        }
+
+        /// Registers an Object type to be drawn by its own loop (Render Thread, or before the first frame)
+        /*! The function T::DrawFrame() is called directly on the Objects having exactly this
+         *  type, or the type PooledObject<T> made by \ref ObjectBase::Allocate(), so it must be
+         *  accessible. The derived classes must be registered separately. The pool allocation
+         *  also keeps the Objects of a type close to each other in the memory.
+         *  \note   Only the call of T::DrawFrame() is bound statically. The functions called by
+         *          it (e.g. \ref Object::Frame() and the activation and the upload of the
+         *          shader variables) are still called virtually, per Object.
+         *  \see Render::SetDrawBuckets() */
+        template <class T>
+        inline void RegisterDrawType(void)
+        {
+            SYS_DEBUG_MEMBER(DM_GLESLY);
+            myDrawTypes.push_back(DrawType());
+            myDrawTypes.back().type = &typeid(T);
+            myDrawTypes.back().pooled = &typeid(Glesly::PooledObject<T>);
+            myDrawTypes.back().draw = &Render::DrawBucket<T>;
+            myBucketVersion = 0;
+        }
+
+        /// Sets the area to be redrawn in the next frames
+        /*! The objects out of this area are not drawn, see \ref ObjectBase::SetScreenBounds().
+         *  \param  area    The redrawn area, or an empty rectangle to draw all of the objects. */
+        inline void SetRedrawArea(const Glesly::DamageRect & area)
+        {
+            myRedrawArea = area;
+        }
+
+        /// Takes the latest committed states of the Render right before each Object is drawn
+        /*! Normally the states of the Render (e.g. the camera and the transformations of
+         *  \ref Render3D) are published and uploaded once, at the start of the frame. In late
+         *  latch mode the states committed while the frame is being drawn are also taken, and
+         *  the uniforms are uploaded again before the next Object, so the changes made by the
+         *  Timer Thread reach the screen up to one frame earlier.
+         *  \note   The Objects drawn before the latch and the ones drawn after it may use different
+         *          camera positions within the same frame. The states of the Objects are not
+         *          latched, they are always taken from the same pass, see
+         *          \ref Render::GetStateGeneration(). */
+        inline void SetLateLatch(bool late_latch = true)
+        {
+            isLateLatch = late_latch;
+        }
+
+        inline bool IsLateLatch(void) const
+        {
+            return isLateLatch;
+        }
+
+        /// Sets the position of the next frame between the last two simulation steps (Timer Thread)
+        /*! \param  alpha   0.0 means the previous step, 1.0 means the last one.
+         *  \see Main::SetSimulationRate() */
+        inline void SetInterpolation(float alpha)
+        {
+            myNextInterpolation.store(alpha, std::memory_order_relaxed);
+        }
+
+        /// The interpolation factor of the actual frame (Render Thread)
+        /*! It can be used in \ref ObjectBase::DrawFrame() to blend the values between the
+         *  simulation steps, see also \ref InterpolatedState. */
+        inline const float & GetInterpolation(void) const
+        {
+            return myInterpolation;
+        }
+
+        /// The timer pass drawn in the actual frame (Render Thread)
+        /*! Each \ref Render::Timer() commits the states of its Objects as one numbered pass, and
+         *  the frame takes the states of the last finished one before drawing, so all of the
+         *  Objects are drawn in the state of the same pass. */
+        inline uint64_t GetStateGeneration(void) const
+        {
+            return myFrameGeneration;
+        }
+
+        /// Timing of the phases of \ref Render::NextFrame()
+        inline const Glesly::FrameStatistics & GetStatistics(void) const
+        {
+            return myStatistics;
+        }
 
      protected:
         Render(Glesly::CameraMatrix & camera, float aspect = 1.0f);
@@ -78,27 +311,250 @@ namespace Glesly
      private:
         SYS_DEFINE_CLASS_NAME("Glesly::Render");
 
-        struct objectIniter
+        /// An element of the stack of the GL initialization requests
+        /*! The elements are allocated from a \ref SlabPool, see \ref Render::InitGLObject(). */
+        struct InitRequest
+        {
+            static inline void * operator new(size_t)
+            {
+                return SlabPool::Get<InitRequest>().Allocate();
+            }
+
+            static inline void operator delete(void * p)
+            {
+                SlabPool::Get<InitRequest>().Free(p);
+            }
+
+            Glesly::Render::InitRequest * next;
+
+            Glesly::ObjectWeak object;
+
+        }; // struct Glesly::Render::InitRequest
+
+        /// An Object waiting for GL initialization
+        struct PendingInit
         {
-            Glesly::Render::objectIniter * next;
+            Glesly::ObjectWeak object;
+
+            int priority;
+
+            /// The weighted cost of the initialization, the smaller ones go first
+            float cost;
+
+            /// Keeps the order of the requests among the equal ones
+            uint64_t sequence;
+
+            /// Tells if this Object should be initialized after the other one
+            inline bool operator<(const PendingInit & other) const
+            {
+                if (priority != other.priority) {
+                    return priority > other.priority;
+                }
+                if (cost != other.cost) {
+                    return cost > other.cost;
+                }
+                return sequence > other.sequence;
+            }
+
+        }; // struct Glesly::Render::PendingInit
+
+        /// An element of the stack of the new timer registrations
+        /*! The elements are allocated from a \ref SlabPool, see \ref Render::RegisterTimer(). */
+        struct TimerRequest
+        {
+            static inline void * operator new(size_t)
+            {
+                return SlabPool::Get<TimerRequest>().Allocate();
+            }
+
+            static inline void operator delete(void * p)
+            {
+                SlabPool::Get<TimerRequest>().Free(p);
+            }
+
+            Glesly::Render::TimerRequest * next;
 
             Glesly::ObjectWeak object;
 
-        }; // struct Glesly::Render::objectIniter
+            uint32_t generation;
+
+            int64_t period;
+
+            bool once;
+
+            /// The time of the registration
+            int64_t time;
+
+        }; // struct Glesly::Render::TimerRequest
+
+        typedef void (*DrawFunction)(Glesly::Render & render, Glesly::ObjectBase * const * objects, size_t count, const SYS::TimeDelay & frame_start_time);
+
+        /// The Objects of a registered type, see \ref Render::RegisterDrawType()
+        struct DrawType
+        {
+            const std::type_info * type;
+
+            /// The type of the pool allocated Objects, see \ref ObjectBase::Allocate()
+            const std::type_info * pooled;
+
+            DrawFunction draw;
+
+            std::vector<Glesly::ObjectBase *> objects;
+
+        }; // struct Glesly::Render::DrawType
+
+        /// Prepares the Object for drawing
+        /*! \retval false  The Object is not initialized yet, or it is known to be out of the
+         *                  redrawn area, it is skipped. */
+        inline bool PrepareDraw(Glesly::ObjectBase & obj)
+        {
+            if (!obj.IsGLInitialized()) {
+                return false;
+            }
+            DamageRect bounds = obj.GetScreenBounds();
+            if (!myRedrawArea.IsEmpty() && !bounds.IsEmpty() && !bounds.Intersects(myRedrawArea)) {
+                return false;
+            }
+            if (isLateLatch) {
+                LatchVariables();
+            }
+            return true;
+        }
+
+        /// The loop drawing the Objects of one type
+        /*! \see Render::RegisterDrawType() about the virtual calls left */
+        template <class T>
+        static void DrawBucket(Glesly::Render & render, Glesly::ObjectBase * const * objects, size_t count, const SYS::TimeDelay & frame_start_time)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                T * obj = static_cast<T *>(objects[i]);
+                if (render.PrepareDraw(*obj)) {
+                    obj->T::DrawFrame(frame_start_time);
+                }
+            }
+        }
+
+        void DrawObjects(const Glesly::Objects::Reader & objects, const SYS::TimeDelay & frame_start_time);
+        void DrawBuckets(const Glesly::Objects::Reader & objects, const SYS::TimeDelay & frame_start_time);
+        void FillBuckets(const Glesly::Objects::Reader & objects);
 
-        Glesly::ObjectPtr GetObject2Init(void);
+        void TakeTimerRequests(void);
+        void CollectDueTimers(void);
+        void DispatchTimers(Glesly::ObjectBase * const * objects, size_t count);
+        void CommitPass(Glesly::ObjectBase * const * objects, size_t count);
+        void PublishPass(void);
+        uint64_t AnnouncePass(void);
+
+        void RunCallbacks(void);
+        void PushInitRequests(InitRequest * top, InitRequest * bottom);
+        void CollectInitRequests(void);
+        void InitPendingObjects(void);
+        void DropRetiredObjects(void);
+        void LatchVariables(void);
 
         Shaders::UniformMatrix_ref<float, 4> myCameraMatrix;
 
-        Threads::Mutex myObjInitMutex;
+        Glesly::FrameStatistics myStatistics;
+
+        Glesly::DamageRect myRedrawArea;
+
+        bool isLateLatch;
+
+        bool isDrawBuckets;
+
+        /// The registered types, in the order of drawing (Render Thread only)
+        std::vector<DrawType> myDrawTypes;
+
+        /// The Objects not having a registered type (Render Thread only)
+        std::vector<Glesly::ObjectBase *> myUnbucketed;
+
+        /// The version of the array the buckets are filled from, see \ref ObjectStore::Reader::GetVersion()
+        uint64_t myBucketVersion;
+
+        float myInterpolation;
+
+        std::atomic<float> myNextInterpolation;
+
+        /// The number of the finished timer passes, see \ref Render::CommitPass()
+        std::atomic<uint64_t> myStateGeneration;
+
+        /// The pass announced by the Render Thread, see \ref Render::AnnouncePass()
+        std::atomic<uint64_t> myReadGeneration;
+
+        /// The number of the pass being committed (Timer Thread only)
+        uint64_t myCommitGeneration;
+
+        /// The value of \ref Render::myReadGeneration at the start of the pass (Timer Thread only)
+        uint64_t myCommitRead;
+
+        /// The generation published for the actual frame (Render Thread only)
+        uint64_t myFrameGeneration;
+
+        /// The top of the stack of the Objects committed since the last frame, see \ref Render::CommitObject()
+        std::atomic<Glesly::ObjectBase *> myDirtyObjects;
+
+        /// The Objects having states not published completely yet (Render Thread only)
+        std::vector<Glesly::ObjectPtr> myPublishedObjects;
+
+        Glesly::TimerPoolPtr myTimerPool;
+
+        /// The top of the stack of the Objects to be dropped, see \ref Render::Retire()
+        std::atomic<Glesly::ObjectBase *> myRetired;
+
+        /// The Objects passed to \ref Render::myTimerPool (used by the Timer Thread only)
+        std::vector<Glesly::ObjectBase *> myParallelTimers;
 
-        objectIniter * objInitList;
+        TimerMode myTimerMode;
 
-        objectIniter * freeObjIniters;
+        /// The top of the stack of the new timer registrations, see \ref Render::RegisterTimer()
+        std::atomic<TimerRequest *> myTimerRequests;
 
-        static constexpr int initerSize = 2000;
+        /// The periodic timers (used by the Timer Thread only)
+        Glesly::TimerWheel myTimerWheel;
 
-        objectIniter initers[initerSize];
+        /// The timers called after each frame (used by the Timer Thread only)
+        std::vector<Glesly::TimerWheel::Entry> myFrameTimers;
+
+        /// The timers expired in the actual turn (used by the Timer Thread only)
+        std::vector<Glesly::TimerWheel::Entry> myDueTimers;
+
+        /// The Objects of the expired timers (used by the Timer Thread only)
+        /*! They are kept alive by their \ref ObjectBase::myTimerSelf during the pass. */
+        std::vector<Glesly::ObjectBase *> myTimerObjects;
+
+        /// The top of the stacks of the Objects having new callbacks, see \ref Render::ScheduleCallbacks()
+        std::atomic<Glesly::ObjectBase *> myCallbackRequests[Glesly::ObjectBase::CALLBACK_PRIORITIES];
+
+        /// The Objects having callbacks, in the order of service (Render Thread only)
+        /*! They are chained by \ref ObjectBase::myCallbackNext. */
+        Glesly::ObjectBase * myCallbackFirst[Glesly::ObjectBase::CALLBACK_PRIORITIES];
+
+        /// The last one of \ref Render::myCallbackFirst (Render Thread only)
+        Glesly::ObjectBase * myCallbackLast[Glesly::ObjectBase::CALLBACK_PRIORITIES];
+
+        int64_t myCallbackBudget;
+
+        /// The top of the stack of the new GL initialization requests, see \ref Render::InitGLObject()
+        std::atomic<InitRequest *> myInitRequests;
+
+        /// The number of GL initialization requests not done yet, see \ref Render::IsGLPending()
+        std::atomic<unsigned> myGLRequests;
+
+        /// The Objects waiting for GL initialization, the next one on the top (Render Thread only)
+        std::priority_queue<PendingInit> myPendingInits;
+
+        /// The sequence number of the next request (Render Thread only)
+        uint64_t myInitSequence;
+
+        int64_t myInitTimeBudget;
+
+        size_t myInitUploadBudget;
+
+        /// The default of \ref Render::SetCallbackBudget(): 4 ms
+        static constexpr int64_t DEFAULT_CALLBACK_BUDGET = 4000000LL;
+
+        /// The upload size which doubles the cost of an initialization, in bytes
+        static constexpr float UPLOAD_COST_UNIT = 65536.0f;
 
     }; // class Glesly::Render
 
@@ -121,6 +577,13 @@ namespace Glesly
             return myRenderInfo.myTransform + index;
         }
 
+        /// The Render Info to be modified by the Timer Thread
+        /*! It is used from the next frame, when the Render Thread publishes it. */
+        inline RenderInfo & GetNextRenderInfo(void)
+        {
+            return myNextRenderInfo.Get();
+        }
+
      protected:
         Render3D(RenderInfo & renderInfo);
         virtual ~Render3D();
@@ -132,6 +595,8 @@ namespace Glesly
         Shaders::UniformMatrix_ref<float, 4> myT3Matrix;
         Shaders::UniformMatrix_ref<float, 4> myT4Matrix;
 
+        Glesly::BufferedState<RenderInfo> myNextRenderInfo;
+
      private:
         SYS_DEFINE_CLASS_NAME("Glesly::Render3D");
 
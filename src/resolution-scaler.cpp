@@ -0,0 +1,250 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Dynamic resolution of the rendering
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <algorithm>
+
+#include <glesly/shader.h>
+#include <glesly/error.h>
+
+#include "resolution-scaler.h"
+
+using namespace Glesly;
+
+/// Stretches the scaled part of the texture to the whole screen
+static const char vertexShader[] =
+    "attribute vec2 a_position;\n"
+    "uniform float u_scale_x;\n"
+    "uniform float u_scale_y;\n"
+    "varying vec2 v_texcoord;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = vec4(a_position, 0.0, 1.0);\n"
+    "    v_texcoord = (a_position * 0.5 + 0.5) * vec2(u_scale_x, u_scale_y);\n"
+    "}\n";
+
+static const char fragmentShader[] =
+    "precision mediump float;\n"
+    "uniform sampler2D u_frame;\n"
+    "varying vec2 v_texcoord;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = texture2D(u_frame, v_texcoord);\n"
+    "}\n";
+
+/// The full-screen quad, as a triangle strip
+static const GLfloat quadVertices[] = {
+    -1.0f, -1.0f,
+     1.0f, -1.0f,
+    -1.0f,  1.0f,
+     1.0f,  1.0f
+};
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ResolutionScaler:                                                           *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*! \param  min_scale   The lowest allowed scale, e.g. 0.5 means half of the width and height.
+ *  \param  max_scale   The highest allowed scale, it is also the initial one. */
+ResolutionScaler::ResolutionScaler(float min_scale, float max_scale):
+    myMinScale(min_scale),
+    myMaxScale(max_scale),
+    myScale(max_scale),
+    myWidth(0),
+    myHeight(0),
+    myFramebuffer(0),
+    myTexture(0),
+    myDepthBuffer(0),
+    myPositionAttrib(-1),
+    myWindowFrames(0),
+    myWindowMaxTime(0),
+    myWindowSumTime(0),
+    myScaleX(*this, "u_scale_x"),
+    myScaleY(*this, "u_scale_y")
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ASSERT(min_scale > 0.0f && min_scale <= max_scale && max_scale <= 1.0f, "invalid scale range: " << min_scale << " - " << max_scale);
+}
+
+ResolutionScaler::~ResolutionScaler()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+void ResolutionScaler::UseShaders(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ AddShader(Shader::CreateBuiltIn(GL_VERTEX_SHADER, vertexShader));
+ AddShader(Shader::CreateBuiltIn(GL_FRAGMENT_SHADER, fragmentShader));
+}
+
+/// Creates the offscreen framebuffer (Render Thread)
+/*! The framebuffer has the full size of the screen, the scale changes only the used part of it,
+ *  so the scale can be changed in any frame without reallocation.
+ *  \param  width   The width of the screen.
+ *  \param  height  The height of the screen.
+ *  \note   If the size of the screen is changed, it must be called again. */
+void ResolutionScaler::InitGL(int width, int height)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (myPositionAttrib < 0) {
+    ProgramInit();
+    InitGLVariables();
+    myPositionAttrib = GetAttribLocationSafe("a_position");
+ }
+
+ if (myFramebuffer) {
+    glDeleteFramebuffers(1, &myFramebuffer);
+    glDeleteRenderbuffers(1, &myDepthBuffer);
+    glDeleteTextures(1, &myTexture);
+ }
+
+ SYS_DEBUG(DL_INFO1, "Offscreen framebuffer: " << width << "x" << height);
+
+ myWidth = width;
+ myHeight = height;
+
+ glGenTextures(1, &myTexture);
+ glBindTexture(GL_TEXTURE_2D, myTexture);
+ glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+ glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+ glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+ glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+ glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+ glBindTexture(GL_TEXTURE_2D, 0);
+
+ glGenRenderbuffers(1, &myDepthBuffer);
+ glBindRenderbuffer(GL_RENDERBUFFER, myDepthBuffer);
+ glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, width, height);
+ glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+ glGenFramebuffers(1, &myFramebuffer);
+ glBindFramebuffer(GL_FRAMEBUFFER, myFramebuffer);
+ glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, myTexture, 0);
+ glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, myDepthBuffer);
+ GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+ glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+ if (status != GL_FRAMEBUFFER_COMPLETE) {
+    throw Error("Offscreen framebuffer is not complete: ") << status;
+ }
+
+ myScaleX = myScale;
+ myScaleY = myScale;
+}
+
+/// Releases the GL resources (Render Thread)
+void ResolutionScaler::CleanupGL(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!myFramebuffer) {
+    return;
+ }
+
+ glDeleteFramebuffers(1, &myFramebuffer);
+ glDeleteRenderbuffers(1, &myDepthBuffer);
+ glDeleteTextures(1, &myTexture);
+
+ myFramebuffer = 0;
+ myTexture = 0;
+ myDepthBuffer = 0;
+ myPositionAttrib = -1;
+
+ ProgramCleanup();
+}
+
+/// Redirects the drawing into the offscreen framebuffer (Render Thread)
+/*! It must be called before clearing the screen. */
+void ResolutionScaler::Begin(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ glBindFramebuffer(GL_FRAMEBUFFER, myFramebuffer);
+ glViewport(0, 0, (GLsizei)(myWidth * myScale + 0.5f), (GLsizei)(myHeight * myScale + 0.5f));
+}
+
+/// Stretches the rendered image to the screen (Render Thread)
+/*! It must be called after all of the Renders have drawn the frame. */
+void ResolutionScaler::End(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ glBindFramebuffer(GL_FRAMEBUFFER, 0);
+ glViewport(0, 0, myWidth, myHeight);
+
+ // The whole screen is overwritten, neither depth test nor blending is needed:
+ glDisable(GL_DEPTH_TEST);
+ glDisable(GL_BLEND);
+
+ UseProgram();
+ ActivateVariables();
+
+ glActiveTexture(GL_TEXTURE0);
+ glBindTexture(GL_TEXTURE_2D, myTexture);
+
+ glVertexAttribPointer(myPositionAttrib, 2, GL_FLOAT, GL_FALSE, 0, quadVertices);
+ glEnableVertexAttribArray(myPositionAttrib);
+ glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+ glDisableVertexAttribArray(myPositionAttrib);
+
+ glBindTexture(GL_TEXTURE_2D, 0);
+ UnuseProgram();
+}
+
+/// Adjusts the scale to the measured frame time (Render Thread)
+/*! The frames are collected into windows of \ref ResolutionScaler::WINDOW_SIZE frames. At the
+ *  end of each window:
+ *  - the scale is decreased if the average frame time is over 90% of the frame period,
+ *  - the scale is increased if even the longest frame was under 70% of the frame period.
+ *
+ *  The gap between the two limits prevents toggling between two neighbouring scales.
+ *  \param  frame_time      The time spent on rendering the actual frame, in nanoseconds,
+ *                          until the GPU has completed it, without the capture and the swap.
+ *  \param  frame_period    The target frame period, in nanoseconds. */
+void ResolutionScaler::Update(int64_t frame_time, int64_t frame_period)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ myWindowSumTime += frame_time;
+ myWindowMaxTime = std::max(myWindowMaxTime, frame_time);
+
+ if (++myWindowFrames < WINDOW_SIZE) {
+    return;
+ }
+
+ float scale = myScale;
+
+ if (myWindowSumTime / WINDOW_SIZE * 10 > frame_period * 9) {
+    scale = std::max(myScale - SCALE_STEP, myMinScale);
+ } else if (myWindowMaxTime * 10 < frame_period * 7) {
+    scale = std::min(myScale + SCALE_STEP, myMaxScale);
+ }
+
+ myWindowFrames = 0;
+ myWindowSumTime = 0;
+ myWindowMaxTime = 0;
+
+ if (scale == myScale) {
+    return;
+ }
+
+ SYS_DEBUG(DL_INFO2, "Resolution scale: " << myScale << " -> " << scale);
+
+ myScale = scale;
+ myScaleX = scale;
+ myScaleY = scale;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,96 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Dynamic resolution of the rendering
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_RESOLUTION_SCALER_H_INCLUDED__
+#define __GLESLY_SRC_RESOLUTION_SCALER_H_INCLUDED__
+
+#include <glesly/program.h>
+#include <Memory/Memory.h>
+
+namespace Glesly
+{
+    /// Renders the frames in reduced resolution when the frame time is too long
+    /*! The Renders draw into an offscreen framebuffer, its size is the screen size multiplied by
+     *  the actual scale. At the end of the frame it is stretched to the screen in one pass.<br>
+     *  The scale is adjusted to the measured frame times: it is decreased if the frames are too
+     *  slow, and increased if there is enough reserve. The decisions are made on windows of
+     *  frames, with different thresholds in the two directions, to prevent oscillation.
+     *  \see Main::SetResolutionScaler() */
+    class ResolutionScaler: public Glesly::Program
+    {
+     public:
+        ResolutionScaler(float min_scale = 0.5f, float max_scale = 1.0f);
+        virtual ~ResolutionScaler();
+
+        void InitGL(int width, int height);
+        void CleanupGL(void);
+        void Begin(void);
+        void End(void);
+        void Update(int64_t frame_time, int64_t frame_period);
+
+        inline bool IsInitialized(int width, int height) const
+        {
+            return myFramebuffer && width == myWidth && height == myHeight;
+        }
+
+        /// The actual scale of the resolution
+        inline float GetScale(void) const
+        {
+            return myScale;
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::ResolutionScaler");
+
+        virtual void UseShaders(void) override;
+
+        /// The number of frames in one decision window
+        static constexpr unsigned WINDOW_SIZE = 30;
+
+        /// The change of the scale in one step
+        static constexpr float SCALE_STEP = 0.1f;
+
+        float myMinScale;
+
+        float myMaxScale;
+
+        float myScale;
+
+        int myWidth;
+
+        int myHeight;
+
+        GLuint myFramebuffer;
+
+        GLuint myTexture;
+
+        GLuint myDepthBuffer;
+
+        GLint myPositionAttrib;
+
+        unsigned myWindowFrames;
+
+        int64_t myWindowMaxTime;
+
+        int64_t myWindowSumTime;
+
+        Glesly::Shaders::UniformFloat myScaleX;
+
+        Glesly::Shaders::UniformFloat myScaleY;
+
+    }; // class ResolutionScaler
+
+    typedef MEM::shared_ptr<ResolutionScaler> ResolutionScalerPtr;
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_RESOLUTION_SCALER_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -89,6 +89,11 @@ namespace Glesly
             void InitGL(void);
             virtual void uninitGL(void) override;
 
+            virtual size_t GetUploadSize(void) const override
+            {
+                return myByteSize;
+            }
+
             void Bind(const void * data, unsigned elements = 0U)
             {
                 SYS_DEBUG_MEMBER(DM_GLESLY);
@@ -435,6 +440,17 @@ namespace Glesly
             }
         }
 
+        inline size_t AttribManager::GetAttribsUploadSize(void) const
+        {
+            SYS_DEBUG_MEMBER(DM_GLESLY);
+            Threads::Lock _l(membersMutex);
+            size_t size = 0;
+            for (AttribElement * i = myAttribs; i; i=i->next) {
+                size += i->GetUploadSize();
+            }
+            return size;
+        }
+
     } // namespace Shaders
 
 } // namespace Glesly
@@ -15,6 +15,7 @@
 #include <glesly/texture-2d.h>
 #include <glesly/texture-cube.h>
 #include <glesly/math/matrix.h>
+#include <glesly/redraw.h>
 #include <glesly/error.h>
 
 namespace Glesly
@@ -28,7 +29,8 @@ namespace Glesly
             inline UniformBase(UniformManager & obj, const char * name):
                 UniformElement(obj),
                 myName(name),
-                myUniformID(-1)
+                myUniformID(-1),
+                myCache(nullptr)
             {
                 SYS_DEBUG_MEMBER(DM_GLESLY);
             }
@@ -49,6 +51,18 @@ namespace Glesly
                 InitGL();
             }
 
+            /// Tells if the value differs from the last one uploaded to this uniform of the program
+            /*! \see UniformManager::GetUniformCache() */
+            inline bool IsChanged(const GLfloat * data, unsigned size)
+            {
+                return !myCache || myCache->Update(GetUniformID(), data, size);
+            }
+
+            inline bool IsChanged(GLint value)
+            {
+                return !myCache || myCache->Update(GetUniformID(), value);
+            }
+
             const char * myName;
 
          private:
@@ -56,10 +70,13 @@ namespace Glesly
 
             GLint myUniformID;
 
+            UniformCache * myCache;
+
             inline void InitGL(void)
             {
                 SYS_DEBUG_MEMBER(DM_GLESLY);
                 myUniformID = GetParent().GetUniformLocationSafe(myName);
+                myCache = GetParent().GetUniformCache();
             }
 
         }; // class UniformBase
@@ -77,6 +94,9 @@ namespace Glesly
             virtual void Activate(void) override
             {
                 SYS_DEBUG_MEMBER(DM_GLESLY);
+                if (!IsChanged(&myRef, 1)) {
+                    return;
+                }
                 SYS_DEBUG(DL_INFO3, " - glUniform1f(" << GetUniformID() << "," << myRef << ");");
                 glUniform1f(GetUniformID(), myRef);
                 CheckEGLError("glUniform1f()");
@@ -102,6 +122,7 @@ namespace Glesly
 
             inline GLfloat operator=(float value)
             {
+                Redraw::Request();
                 return myValue = value;
             }
 
@@ -140,9 +161,11 @@ namespace Glesly
                 SYS_DEBUG(DL_INFO3, " - glActiveTexture(GL_TEXTURE" << myIndex << ");");
                 glActiveTexture(GL_TEXTURE0 + myIndex);
                 CheckEGLError("glActiveTexture()");
-                SYS_DEBUG(DL_INFO3, " - glUniform1i(" << GetUniformID() << "," << myIndex << ");");
-                glUniform1i(GetUniformID(), myIndex);
-                CheckEGLError("glUniform1i()");
+                if (IsChanged(myIndex)) {
+                    SYS_DEBUG(DL_INFO3, " - glUniform1i(" << GetUniformID() << "," << myIndex << ");");
+                    glUniform1i(GetUniformID(), myIndex);
+                    CheckEGLError("glUniform1i()");
+                }
                 Bind();
             }
 
@@ -151,6 +174,11 @@ namespace Glesly
                 InitGL();
             }
 
+            virtual size_t GetUploadSize(void) const override
+            {
+                return Texture2DRaw::GetByteSize();
+            }
+
          protected:
             int myIndex;
 
@@ -188,9 +216,11 @@ namespace Glesly
                 SYS_DEBUG(DL_INFO3, " - glActiveTexture(GL_TEXTURE" << myIndex << ");");
                 glActiveTexture(GL_TEXTURE0 + myIndex);
                 CheckEGLError("glActiveTexture()");
-                SYS_DEBUG(DL_INFO3, " - glUniform1i(" << GetUniformID() << "," << myIndex << ");");
-                glUniform1i(GetUniformID(), myIndex);
-                CheckEGLError("glUniform1i()");
+                if (IsChanged(myIndex)) {
+                    SYS_DEBUG(DL_INFO3, " - glUniform1i(" << GetUniformID() << "," << myIndex << ");");
+                    glUniform1i(GetUniformID(), myIndex);
+                    CheckEGLError("glUniform1i()");
+                }
                 Bind();
             }
 
@@ -201,6 +231,11 @@ namespace Glesly
                 TextureCubeMap::InitGL();
             }
 
+            virtual size_t GetUploadSize(void) const override
+            {
+                return TextureCubeMap::GetByteSize();
+            }
+
          protected:
             int myIndex;
 
@@ -228,6 +263,9 @@ namespace Glesly
             virtual void Activate(void) override
             {
                 SYS_DEBUG_MEMBER(DM_GLESLY);
+                if (!UniformBase::IsChanged(myVariable.get(), N * N)) {
+                    return;
+                }
                 switch (N) {
                     case 2:
                         SYS_DEBUG(DL_INFO3, " - glUniformMatrix2fv(" << UniformBase::GetUniformID() << ",1,GL_FALSE," << myVariable << "); name: '" << myName << "'");
@@ -313,6 +351,17 @@ namespace Glesly
             }
         }
 
+        inline size_t UniformManager::GetUniformsUploadSize(void) const
+        {
+            SYS_DEBUG_MEMBER(DM_GLESLY);
+            Threads::Lock _l(membersMutex);
+            size_t size = 0;
+            for (UniformElement * var = myVars; var; var=var->next) {
+                size += var->GetUploadSize();
+            }
+            return size;
+        }
+
     } // namespace Shaders
 
 } // namespace Glesly
@@ -8,6 +8,8 @@
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <string.h>
+
 #include "shader-vars.h"
 
 using namespace Glesly::Shaders;
@@ -21,4 +23,60 @@ void AttribManager::UninitGL(void)
  }
 }
 
+/// Stores the value if it differs from the last one
+/*! \param  location    The location of the uniform.
+ *  \param  data        The value to be uploaded.
+ *  \param  size        The number of floats in the value, at most \ref UniformCache::MAX_SIZE.
+ *  \retval true        The value has been changed, it must be uploaded.
+ *  \retval false       The program has the same value, the upload can be skipped. */
+bool UniformCache::Update(GLint location, const GLfloat * data, unsigned size)
+{
+ if (location < 0 || size > MAX_SIZE) {
+    return true;
+ }
+
+ Entry & entry = GetEntry(location);
+
+ if (entry.valid && !memcmp(entry.data, data, size * sizeof(GLfloat))) {
+    return false;
+ }
+
+ memcpy(entry.data, data, size * sizeof(GLfloat));
+ entry.valid = true;
+
+ return true;
+}
+
+/// Stores the integer value (e.g. a sampler) if it differs from the last one
+/*! \see UniformCache::Update(GLint, const GLfloat *, unsigned) */
+bool UniformCache::Update(GLint location, GLint value)
+{
+ GLfloat data[1];
+ memcpy(data, &value, sizeof(GLint));
+
+ return Update(location, data, 1);
+}
+
+/// Forgets the values, e.g. when the program is (re)linked
+void UniformCache::Reset(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ for (std::vector<Entry>::iterator i = myEntries.begin(); i != myEntries.end(); ++i) {
+    i->valid = false;
+ }
+}
+
+UniformCache::Entry & UniformCache::GetEntry(GLint location)
+{
+ if ((size_t)location >= myEntries.size()) {
+    // The locations are small numbers, and it is done once per location:
+    Entry empty;
+    empty.valid = false;
+    myEntries.resize(location + 1, empty);
+ }
+
+ return myEntries[location];
+}
+
 /* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
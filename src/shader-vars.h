@@ -13,6 +13,8 @@
 
 #include <GLES2/gl2.h>
 
+#include <vector>
+
 #include <Threads/Mutex.h>
 #include <Debug/Debug.h>
 
@@ -44,12 +46,15 @@ namespace Glesly
             void BufferVariables(void);
             void UnbufferVariables(void);
 
+            /// The amount of data uploaded by the attributes, in bytes
+            size_t GetAttribsUploadSize(void) const;
+
          private:
             SYS_DEFINE_CLASS_NAME("Glesly::Shaders::AttribManager");
 
             AttribElement * myAttribs;
 
-            Threads::Mutex membersMutex;
+            mutable Threads::Mutex membersMutex;
 
         }; // class AttribManager
 
@@ -68,6 +73,12 @@ namespace Glesly
             {
             }
 
+            /// The amount of data uploaded by this attribute, in bytes
+            virtual size_t GetUploadSize(void) const
+            {
+                return 0;
+            }
+
          protected:
             inline AttribElement(AttribManager & parent):
                 myParent(parent),
@@ -98,6 +109,38 @@ namespace Glesly
 
         class UniformElement;
 
+        /// The last values uploaded to the uniforms of a program
+        /*! The program object keeps the values of its uniforms, so uploading the same value
+         *  again can be skipped. The values are stored by the location of the uniforms, so the
+         *  Objects sharing a uniform (e.g. 'p_matrix') also share its entry.
+         *  \note   It is used by the Render Thread only. */
+        class UniformCache
+        {
+         public:
+            bool Update(GLint location, const GLfloat * data, unsigned size);
+            bool Update(GLint location, GLint value);
+            void Reset(void);
+
+            /// The largest value stored, in floats (a 4x4 matrix)
+            static constexpr unsigned MAX_SIZE = 16;
+
+         private:
+            SYS_DEFINE_CLASS_NAME("Glesly::Shaders::UniformCache");
+
+            struct Entry
+            {
+                bool valid;
+
+                GLfloat data[MAX_SIZE];
+
+            }; // struct Glesly::Shaders::UniformCache::Entry
+
+            Entry & GetEntry(GLint location);
+
+            std::vector<Entry> myEntries;
+
+        }; // class UniformCache
+
         class UniformManager
         {
          public:
@@ -117,14 +160,24 @@ namespace Glesly
             void ActivateVariables(void);
             void InitGLVariables(void);
 
+            /// The amount of data uploaded by the uniforms, in bytes
+            size_t GetUniformsUploadSize(void) const;
+
             virtual GLint GetUniformLocationSafe(const char * name) const =0;
 
+            /// The cache of the program the uniforms belong to
+            /*! \retval NULL   The uniforms are uploaded each time. */
+            virtual UniformCache * GetUniformCache(void) const
+            {
+                return nullptr;
+            }
+
          private:
             SYS_DEFINE_CLASS_NAME("Glesly::Shaders::UniformManager");
 
             UniformElement * myVars;
 
-            Threads::Mutex membersMutex;
+            mutable Threads::Mutex membersMutex;
 
         }; // class UniformManager
 
@@ -137,11 +190,16 @@ namespace Glesly
                 SYS_DEBUG_MEMBER(DM_GLESLY);
             }
 
-            virtual GLint GetUniformLocationSafe(const char * name) const
+            virtual GLint GetUniformLocationSafe(const char * name) const override
             {
                 return myParent.GetUniformLocationSafe(name);
             }
 
+            virtual UniformCache * GetUniformCache(void) const override
+            {
+                return myParent.GetUniformCache();
+            }
+
          private:
             SYS_DEFINE_CLASS_NAME("Glesly::Shaders::UniformManagerCopy");
 
@@ -162,6 +220,13 @@ namespace Glesly
 
             virtual void initGL(void) =0;
 
+            /// The amount of data uploaded by this uniform, in bytes
+            /*! The textures are counted only, the other uniforms are negligible. */
+            virtual size_t GetUploadSize(void) const
+            {
+                return 0;
+            }
+
          protected:
             inline UniformElement(UniformManager & parent):
                 myParent(parent),
@@ -12,6 +12,7 @@
 #define __GLESLY_SRC_SHADER_H_INCLUDED__
 
 #include <string>
+#include <string.h>
 #include <vector>
 #include <Memory/Memory.h>
 
@@ -79,6 +80,13 @@ namespace Glesly
             return ShaderPtr(new Shader(type, r.GetSource(), r.GetLength()));
         }
 
+        /// Creates a shader from a source built in the library
+        /*! The source is never looked up in the shader files, see \ref USE_SHADER_FILES. */
+        inline static ShaderPtr CreateBuiltIn(GLenum type, const char * source)
+        {
+            return ShaderPtr(new Shader(type, source, strlen(source)));
+        }
+
         inline GLuint GetShaderID(void)
         {
             return myShader;
@@ -30,6 +30,10 @@ void SphereSurface::updatePointers(void)
  textureTargets[3] = &*pacaTargets[3];
  textureTargets[4] = &*pacaTargets[4];
  textureTargets[5] = &*pacaTargets[5];
+
+ // They refer to the previous targets:
+ Threads::Lock _l(myDrawsMutex);
+ myDraws.clear();
 }
 
 /// Creates an empty (black or transparent) texture for the whole sphere
@@ -113,10 +117,31 @@ void SphereSurface::reset(PaCaLib::TargetPtr & target, const char * name, int &
 /// Return a \ref PaCaLib::Draw instance
 /*! The surface of the sphere can be drawn using the usual drawing interface. The x and y parameters of the
  *  drawing functions are angles (longitude and latitude).<br>
- *  The value range of x and y is -1.0 ... +1.0 due to compatibility reasons. */
+ *  The value range of x and y is -1.0 ... +1.0 due to compatibility reasons.
+ *  \note   Each thread has its own instance, it is reused with a fresh drawing state when the
+ *          previous caller of the same thread has released it. */
 PaCaLib::DrawPtr SphereSurface::Draw(void)
 {
- return PaCaLib::DrawPtr(new SphereData::Draw(*this));
+ std::thread::id self = std::this_thread::get_id();
+
+ Threads::Lock _l(myDrawsMutex);
+
+ for (std::vector<std::pair<std::thread::id, PaCaLib::DrawPtr> >::iterator i = myDraws.begin(); i != myDraws.end(); ++i) {
+    if (i->first != self) {
+        continue;
+    }
+    // Only this thread has got copies of it, so nobody can take a new one meanwhile:
+    if (i->second.use_count() == 1) {
+        static_cast<SphereData::Draw &>(*i->second).Reset();
+    } else {
+        i->second = PaCaLib::DrawPtr(new SphereData::Draw(*this));
+    }
+    return i->second;
+ }
+
+ myDraws.push_back(std::make_pair(self, PaCaLib::DrawPtr(new SphereData::Draw(*this))));
+
+ return myDraws.back().second;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
@@ -126,24 +151,47 @@ PaCaLib::DrawPtr SphereSurface::Draw(void)
 \* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 SphereData::Convert3D::Operations::Operations(const_iterator start, const_iterator _end):
-    opCount(0)
+    opCount(0),
+    hasSubOperations(false)
+{
+ SYS_DEBUG_MEMBER(DM_GL_SPHERE);
+
+ assign(start, _end);
+
+ SYS_DEBUG(DL_INFO1, "Created " << *this);
+}
+
+SphereData::Convert3D::Operations::Operations(const SphereData::Convert3D::Operations & original, int mode):
+    opCount(0),
+    hasSubOperations(false)
 {
  SYS_DEBUG_MEMBER(DM_GL_SPHERE);
 
+ convert(original, mode);
+}
+
+/// Replaces the operations by the given range
+void SphereData::Convert3D::Operations::assign(const_iterator start, const_iterator _end)
+{
+ SYS_DEBUG_MEMBER(DM_GL_SPHERE);
+
+ clear();
+
  for ( ; start <= _end; ++start) {
     ASSERT(opCount < MAX_OPERS, "Too many operations");
     opcodes[opCount++] = *start;
  }
-
- SYS_DEBUG(DL_INFO1, "Created " << *this);
 }
 
-SphereData::Convert3D::Operations::Operations(const SphereData::Convert3D::Operations & original, int mode)
+/// Replaces the operations by the ones of the original, converted to the given surface
+void SphereData::Convert3D::Operations::convert(const SphereData::Convert3D::Operations & original, int mode)
 {
  SYS_DEBUG_MEMBER(DM_GL_SPHERE);
 
  static constexpr float Z_LIMIT = 0.06f;
 
+ clear();
+
  opCount = original.opCount;
 
  SYS_DEBUG(DL_INFO2, "Converting " << original << " ...");
@@ -285,6 +333,8 @@ void SphereData::Convert3D::Operations::append(const_iterator start, const_itera
 {
  SYS_DEBUG_MEMBER(DM_GL_SPHERE);
 
+ hasSubOperations = false;
+
  if (size() > 0) {
     if (opcodes[opCount-1].op == OneOp::OP_CLOSE) {
         --opCount;
@@ -306,6 +356,8 @@ void SphereData::Convert3D::Operations::append(const Operations & other)
 {
  SYS_DEBUG_MEMBER(DM_GL_SPHERE);
 
+ hasSubOperations = false;
+
  if (other.size() == 0) {
     return;
  }
@@ -321,11 +373,25 @@ void SphereData::Convert3D::Operations::append(const Operations & other)
  }
 }
 
-const SphereData::Convert3D::OperPtr * SphereData::Convert3D::Operations::getSubOperations(void) const
+/// A cleared sub-operation list, allocated only at the first use
+SphereData::Convert3D::Operations * SphereData::Convert3D::Operations::getPooled(int index) const
+{
+ if (!sub_pool[index]) {
+    sub_pool[index] = Operations::Create();
+ }
+
+ sub_pool[index]->clear();
+
+ return sub_pool[index].get();
+}
+
+SphereData::Convert3D::Operations * const * SphereData::Convert3D::Operations::getSubOperations(void) const
 {
  SYS_DEBUG_MEMBER(DM_GL_SPHERE);
 
- if (!sub_opers[0]) {
+ if (!hasSubOperations) {
+    hasSubOperations = true;
+
     enum _State
     {
         SEEK    = 0,
@@ -388,25 +454,28 @@ const SphereData::Convert3D::OperPtr * SphereData::Convert3D::Operations::getSub
 
     if (size <= 0) {
         SYS_DEBUG(DL_INFO1, " - Creating only an empty object...");
-        sub_opers[0] = Operations::Create();    // Create just one, empty list
+        sub_opers[0] = getPooled(0);    // Create just one, empty list
+        size = 1;
     } else {
         for (int i = 0; i < size; ++i) {
             if (last_is_close && i == 0 && size > 1) {
                 SYS_DEBUG(DL_INFO1, " - Skip the object #0...");
             } else {
                 SYS_DEBUG(DL_INFO1, " - Creating object #" << i << "...");
-                sub_opers[i] = Operations::Create(entries[i].begin, entries[i].end);
+                sub_opers[i] = getPooled(i);
+                sub_opers[i]->assign(entries[i].begin, entries[i].end);
             }
         }
         if (last_is_close && size > 1) {
             SYS_DEBUG(DL_INFO1, " - Appending the first and last lists...");
             --size; // One less elements are needed
             sub_opers[0] = sub_opers[size];
-            sub_opers[size].reset();
             sub_opers[0]->append(entries[0].begin, entries[0].end);
             SYS_DEBUG(DL_INFO1, " - Result for the first entry: " << *sub_opers[0]);
         }
     }
+
+    sub_opers[size] = nullptr;
  }
 
  return sub_opers;
@@ -455,6 +524,18 @@ SphereData::Draw::Draw(SphereSurface & parent):
  }
 }
 
+/// Drops the drawing state of the previous user
+/*! The drawing contexts of the surfaces are taken again, as a new instance does. The buffers of
+ *  the path conversion are kept. */
+void SphereData::Draw::Reset(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ for (int i = 0; i < 6; ++i) {
+    draws[i] = parent.GetDraw(i);
+ }
+}
+
 void SphereData::Draw::Scale(float w, float h)
 {
  ASSERT(false, "Scale() cannot be used on sphere");
@@ -610,9 +691,9 @@ void SphereData::Draw::DrawPath(PaCaLib::Path::DrawMode mode, const Operations &
  SYS_DEBUG_MEMBER(DM_GL_SPHERE);
 
  for (int i = 0; i < 6; ++i) {
-    Operations op(ops, i);
+    myConverted.convert(ops, i);
 
-    for (const SphereData::Convert3D::OperPtr * subops = op.getSubOperations(); *subops; ++subops) {
+    for (const Operations * const * subops = myConverted.getSubOperations(); *subops; ++subops) {
         DrawPath(mode, i, **subops);
     }
  }
@@ -11,8 +11,13 @@
 #ifndef __SRC_SPHERE_H_INCLUDED__
 #define __SRC_SPHERE_H_INCLUDED__
 
+#include <thread>
+#include <vector>
+#include <utility>
+
 #include <pacalib/pacalib.h>
 #include <glesly/surfaced-icosahedron.h>
+#include <Threads/Mutex.h>
 #include <Memory/Memory.h>
 #include <Debug/Debug.h>
 
@@ -67,7 +72,8 @@ namespace Glesly
                 typedef const OneOp * const_iterator;
 
                 inline Operations(void):
-                    opCount(0)
+                    opCount(0),
+                    hasSubOperations(false)
                 {
                 }
 
@@ -243,9 +249,18 @@ namespace Glesly
                     opcodes[opCount++] = *data;
                 }
 
+                /// Removes all operations, the allocated sub-operations are kept for reuse
+                inline void clear(void)
+                {
+                    opCount = 0;
+                    hasSubOperations = false;
+                }
+
+                void assign(const_iterator start, const_iterator _end);
+                void convert(const Operations & original, int mode);
                 void append(const Operations & other);
                 void append(const_iterator start, const_iterator _end);
-                const OperPtr * getSubOperations(void) const;
+                Operations * const * getSubOperations(void) const;
                 void toStream(std::ostream & os) const;
 
              protected:
@@ -280,7 +295,17 @@ namespace Glesly
 
                 int     opCount;
 
-                mutable OperPtr sub_opers[MAX_LOOPS+1];
+                /// The result of \ref Operations::getSubOperations(), terminated by NULL
+                mutable Operations * sub_opers[MAX_LOOPS+1];
+
+                /// The sub-operations allocated so far, they are reused by the next conversions
+                mutable OperPtr sub_pool[MAX_LOOPS+1];
+
+                /// Tells if \ref Operations::sub_opers is up to date
+                mutable bool hasSubOperations;
+
+             private:
+                Operations * getPooled(int index) const;
 
              private:
                 SYS_DEFINE_CLASS_NAME("Glesly::SphereData::Convert3D::Operations");
@@ -301,6 +326,8 @@ namespace Glesly
 
             void DrawPath(PaCaLib::Path::DrawMode mode, const Operations & ops);
 
+            void Reset(void);
+
          protected:
             SphereSurface & parent;
 
@@ -320,6 +347,9 @@ namespace Glesly
          private:
             SYS_DEFINE_CLASS_NAME("Glesly::SphereSurface::Draw");
 
+            /// Reused for each converted path, see \ref SphereData::Draw::DrawPath()
+            Operations myConverted;
+
             void DrawPath(PaCaLib::Path::DrawMode mode, int index, const Operations & ops);
             bool DrawFillOnly(PaCaLib::Path::DrawMode mode, int index, const Operations & ops);
             float DrawTextInternal(const PaCaLib::Draw::TextParams & params, PaCaLib::Draw::Distortion & distortion, float x, float y, float z, float corr, int index);
@@ -396,6 +426,11 @@ namespace Glesly
         void reset(PaCaLib::TargetPtr & target, const char * name, int & size);
         void updatePointers(void);
 
+        /// The instances of \ref SphereSurface::Draw(), one for each calling thread
+        std::vector<std::pair<std::thread::id, PaCaLib::DrawPtr> > myDraws;
+
+        Threads::Mutex myDrawsMutex;
+
     }; // class Glesly::SphereSurface
 
     /// OpenGL Sphere object, with drawing capabilities
@@ -415,7 +450,7 @@ namespace Glesly
      public:
         inline static Glesly::ObjectPtr Create(Glesly::Render & render, float radius, int size = 0)
         {
-            return (new Sphere(render, radius, size))->ObjectBase::Create();
+            return Glesly::ObjectBase::Allocate<Sphere>(render, radius, size);
         }
 
         virtual ~Sphere()
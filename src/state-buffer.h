@@ -0,0 +1,378 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Buffered state shared between the Timer and the Render Threads
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_STATE_BUFFER_H_INCLUDED__
+#define __GLESLY_SRC_STATE_BUFFER_H_INCLUDED__
+
+#include <stdint.h>
+#include <atomic>
+
+#include <glesly/redraw.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// Lock-free buffer to pass a state from one writer to one reader thread
+    /*! The writer (the Timer Thread) modifies its own copy, and commits it at the end of a timer
+     *  pass, tagged by the number of the pass. The reader (the Render Thread) takes the last copy
+     *  committed until the pass it has announced, see \ref Render::PublishPass(). Three slots are
+     *  used: the writer never overwrites the last committed one and the one announced by the
+     *  reader, so neither side waits for the other, and all of the states of a frame are taken
+     *  from the same pass. */
+    template <class T>
+    class StateBuffer
+    {
+     public:
+        inline StateBuffer(void):
+            myFront(0),
+            myFrontPass(0)
+        {
+            myPasses[0] = 0;
+            myPasses[1] = 0;
+            myPasses[2] = 0;
+        }
+
+        inline StateBuffer(const T & initial):
+            StateBuffer()
+        {
+            myBack = initial;
+            mySlots[0] = initial;
+            mySlots[1] = initial;
+            mySlots[2] = initial;
+        }
+
+        /// The copy to be modified by the writer thread
+        inline T & GetBack(void)
+        {
+            return myBack;
+        }
+
+        /// The copy taken by the last \ref StateBuffer::Publish() (reader side)
+        inline const T & GetFront(void) const
+        {
+            return mySlots[myFront];
+        }
+
+        /// Passes the copy of the writer to the reader (writer side)
+        /*! The copy of the writer is kept, so it can continue with partial modifications.
+         *  \param  pass    The number of the actual timer pass.
+         *  \param  read    The last pass announced by the reader. */
+        inline void Commit(uint64_t pass, uint64_t read)
+        {
+            uint64_t tags[3];
+            unsigned latest = 0;
+            unsigned kept = 3;
+            for (unsigned i = 0; i < 3; ++i) {
+                tags[i] = myPasses[i].load(std::memory_order_relaxed);
+                if (tags[i] > tags[latest]) {
+                    latest = i;
+                }
+                if (tags[i] <= read && (kept == 3 || tags[i] > tags[kept])) {
+                    kept = i;
+                }
+            }
+            unsigned target = latest;
+            if (tags[latest] != pass) {
+                // Neither the last committed nor the announced one can be overwritten:
+                target = 0;
+                while (target == latest || target == kept) {
+                    ++target;
+                }
+            }
+            mySlots[target] = myBack;
+            myPasses[target].store(pass, std::memory_order_release);
+        }
+
+        /// Takes the last copy committed until the given pass (reader side)
+        /*! \param  read    The pass announced by the reader.
+         *  \retval true    A new state has been published.
+         *  \retval false   There was no commit since the previous call. */
+        inline bool Publish(uint64_t read)
+        {
+            unsigned found = myFront;
+            uint64_t found_pass = myFrontPass;
+            for (unsigned i = 0; i < 3; ++i) {
+                uint64_t tag = myPasses[i].load(std::memory_order_acquire);
+                if (tag <= read && tag > found_pass) {
+                    found = i;
+                    found_pass = tag;
+                }
+            }
+            if (found_pass == myFrontPass) {
+                return false;
+            }
+            myFront = found;
+            myFrontPass = found_pass;
+            return true;
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::StateBuffer");
+
+        T mySlots[3];
+
+        /// The passes the slots have been committed in
+        std::atomic<uint64_t> myPasses[3];
+
+        /// The copy of the writer
+        T myBack;
+
+        unsigned myFront;
+
+        uint64_t myFrontPass;
+
+    }; // class StateBuffer
+
+    class StateElement;
+
+    /// Container of buffered states
+    /*! The states are registered by their constructors, and they are committed by the Timer
+     *  Thread after \ref ObjectBase::Timer(), and published by the Render Thread before drawing.
+     *  The passes are numbered by the Render, see \ref Render::CommitPass().
+     *  \note   The states must be created and deleted together with their owner, before it is
+     *          shared with other threads. */
+    class StateManager
+    {
+        friend class StateElement;
+
+     public:
+        inline StateManager(void):
+            myStates(nullptr)
+        {
+        }
+
+        inline bool CommitStates(uint64_t pass, uint64_t read);
+        inline bool PublishStates(uint64_t read);
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::StateManager");
+
+        StateElement * myStates;
+
+    }; // class StateManager
+
+    class StateElement
+    {
+        friend class StateManager;
+
+     public:
+        virtual ~StateElement()
+        {
+            for (StateElement ** i = &myParent.myStates; *i; i = &(*i)->next) {
+                if (*i == this) {
+                    *i = next;
+                    break;
+                }
+            }
+        }
+
+     protected:
+        inline StateElement(StateManager & parent):
+            myParent(parent),
+            next(parent.myStates)
+        {
+            parent.myStates = this;
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::StateElement");
+
+        virtual bool Commit(uint64_t pass, uint64_t read) =0;
+        virtual bool Publish(uint64_t read) =0;
+
+        StateManager & myParent;
+
+        StateElement * next;
+
+    }; // class StateElement
+
+    /// A buffered copy of a variable used by the Render Thread
+    /*! The variable itself (e.g. a transformation referenced by a uniform) is read by the Render
+     *  Thread only. The other thread modifies the copy returned by \ref BufferedState::Get(), and
+     *  the modification is copied to the variable when the state is published. */
+    template <class T>
+    class BufferedState: public StateElement
+    {
+     public:
+        inline BufferedState(StateManager & parent, T & variable):
+            StateElement(parent),
+            myVariable(variable),
+            myBuffer(variable),
+            myModified(false)
+        {
+        }
+
+        /// The copy to be modified (Timer Thread)
+        inline T & Get(void)
+        {
+            myModified = true;
+            return myBuffer.GetBack();
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::BufferedState");
+
+        virtual bool Commit(uint64_t pass, uint64_t read) override
+        {
+            if (!myModified) {
+                return false;
+            }
+            myModified = false;
+            myBuffer.Commit(pass, read);
+            Redraw::Request();
+            return true;
+        }
+
+        virtual bool Publish(uint64_t read) override
+        {
+            if (!myBuffer.Publish(read)) {
+                return false;
+            }
+            myVariable = myBuffer.GetFront();
+            return true;
+        }
+
+        T & myVariable;
+
+        StateBuffer<T> myBuffer;
+
+        bool myModified;
+
+    }; // class BufferedState
+
+    /// A buffered variable blended between the last two simulation steps
+    /*! It is similar to \ref BufferedState, but each commit carries the previous state too, and
+     *  the variable is calculated as a blend of the two ones, using the interpolation factor
+     *  of the actual frame (see \ref Main::SetSimulationRate()).<br>
+     *  The type must have a member function Blend(from, to, alpha), see e.g.
+     *  \ref Transformation::Blend().
+     *  \note   If the state is not modified in a step, it is committed once more to stop the
+     *          movement, so the variable settles exactly on the last state. */
+    template <class T>
+    class InterpolatedState: public StateElement
+    {
+     public:
+        /*! \param  alpha   The interpolation factor, it is read by the Render Thread only. */
+        inline InterpolatedState(StateManager & parent, T & variable, const float & alpha):
+            StateElement(parent),
+            myVariable(variable),
+            myAlpha(alpha),
+            myBuffer(Steps(variable)),
+            myLast(variable),
+            myModified(false),
+            isMoving(false)
+        {
+        }
+
+        /// The copy to be modified (Timer Thread)
+        inline T & Get(void)
+        {
+            myModified = true;
+            return myBuffer.GetBack().to;
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::InterpolatedState");
+
+        struct Steps
+        {
+            inline Steps(void):
+                moving(false)
+            {
+            }
+
+            inline Steps(const T & value):
+                from(value),
+                to(value),
+                moving(false)
+            {
+            }
+
+            T from;
+
+            T to;
+
+            bool moving;
+
+        }; // struct Glesly::InterpolatedState::Steps
+
+        virtual bool Commit(uint64_t pass, uint64_t read) override
+        {
+            if (!myModified && !isMoving) {
+                return false;
+            }
+            Steps & back = myBuffer.GetBack();
+            back.from = myLast;
+            back.moving = myModified;
+            myLast = back.to;
+            isMoving = myModified;
+            myModified = false;
+            myBuffer.Commit(pass, read);
+            Redraw::Request();
+            return true;
+        }
+
+        /*! \retval true    The state has been changed, or it is still being blended. */
+        virtual bool Publish(uint64_t read) override
+        {
+            bool fresh = myBuffer.Publish(read);
+            const Steps & front = myBuffer.GetFront();
+            if (front.moving && myAlpha < 1.0f) {
+                myVariable.Blend(front.from, front.to, myAlpha);
+                return true;
+            }
+            if (fresh) {
+                myVariable = front.to;
+            }
+            return fresh;
+        }
+
+        T & myVariable;
+
+        const float & myAlpha;
+
+        StateBuffer<Steps> myBuffer;
+
+        /// The state committed in the previous step (Timer Thread)
+        T myLast;
+
+        bool myModified;
+
+        bool isMoving;
+
+    }; // class InterpolatedState
+
+    /*! \retval true    At least one of the states has been committed. */
+    inline bool StateManager::CommitStates(uint64_t pass, uint64_t read)
+    {
+        bool committed = false;
+        for (StateElement * i = myStates; i; i = i->next) {
+            committed |= i->Commit(pass, read);
+        }
+        return committed;
+    }
+
+    /*! \retval true    At least one of the states has been changed. */
+    inline bool StateManager::PublishStates(uint64_t read)
+    {
+        bool changed = false;
+        for (StateElement * i = myStates; i; i = i->next) {
+            changed |= i->Publish(read);
+        }
+        return changed;
+    }
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_STATE_BUFFER_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -30,6 +30,22 @@ Target::~Target()
  SYS_DEBUG_MEMBER(DM_GLESLY);
 }
 
+const EGLint * Target::GetEGLConfigAttribs(void) const
+{
+ static const EGLint attribs[] = {
+    EGL_SURFACE_TYPE,       EGL_WINDOW_BIT,
+    EGL_RENDERABLE_TYPE,    EGL_OPENGL_ES2_BIT,
+    EGL_RED_SIZE,           5,
+    EGL_GREEN_SIZE,         6,
+    EGL_BLUE_SIZE,          5,
+    EGL_ALPHA_SIZE,         0,
+    EGL_DEPTH_SIZE,         16,
+    EGL_NONE
+ };
+
+ return attribs;
+}
+
 void Target::CloseRequest(void)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
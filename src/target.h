@@ -54,6 +54,11 @@ namespace Glesly
         virtual bool EnterEventLoop(void) =0;
         virtual void Wait4Sync(void) { }
 
+        /// The attributes to select the EGL configuration
+        /*! The default configuration is RGB565 with 16-bit depth buffer on a window surface.
+         *  \retval The attribute list, terminated by EGL_NONE. */
+        virtual const EGLint * GetEGLConfigAttribs(void) const;
+
         inline void RegisterParent(TargetHolder * parent = NULL)
         {
             myParent = parent;
@@ -77,6 +77,19 @@ void Texture2DRaw::Update(void)
  }
 }
 
+size_t Texture2DRaw::GetByteSize(void) const
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ size_t size = (size_t)myWidth * myHeight * Glesly::Format2PixelSize(myTarget.GetPixelFormat());
+
+ if (myUseMipmap) {
+    size += size / 3; // the levels add up to one third of the base level
+ }
+
+ return size;
+}
+
 void Texture2DRaw::InitGL(void)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
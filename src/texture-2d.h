@@ -73,6 +73,10 @@ namespace Glesly
 
         void InitGL(void);
 
+        /// The amount of data uploaded by \ref Texture2DRaw::Update(), in bytes
+        /*! The mipmap levels are counted too. */
+        size_t GetByteSize(void) const;
+
      private:
         SYS_DEFINE_CLASS_NAME("Glesly::Texture2DRaw");
 
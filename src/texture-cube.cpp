@@ -37,6 +37,30 @@ TextureCubeMap::~TextureCubeMap()
  }
 }
 
+size_t TextureCubeMap::GetByteSize(void) const
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ const Target2D * const * targets = getTargets();
+
+ if (!targets[0]) {
+    return 0; // not initialized yet
+ }
+
+ unsigned pixel_size = Glesly::Format2PixelSize(targets[0]->GetPixelFormat());
+ size_t size = 0;
+
+ for (unsigned i = 0; i < 6; ++i) {
+    size += (size_t)targets[i]->GetWidth() * targets[i]->GetHeight() * pixel_size;
+ }
+
+ if (myUseMipmap) {
+    size += size / 3; // the levels add up to one third of the base level
+ }
+
+ return size;
+}
+
 void TextureCubeMap::Update(void)
 {
  SYS_DEBUG_MEMBER(DM_GLESLY);
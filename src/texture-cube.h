@@ -52,6 +52,11 @@ namespace Glesly
         void InitGL();
         void UninitGL();
 
+        /// The amount of data uploaded by \ref TextureCubeMap::Update(), in bytes
+        /*! The mipmap levels are counted too.
+         *  \retval 0     The images are not available yet. */
+        size_t GetByteSize(void) const;
+
      private:
         SYS_DEFINE_CLASS_NAME("Glesly::TextureCubeMap");
 
@@ -0,0 +1,66 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     CPU affinity and scheduling of the threads
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <pthread.h>
+#include <string.h>
+
+#include "thread-policy.h"
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class ThreadPolicy:                                                               *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/// Applies the policy to the calling thread
+/*! A failure is not fatal: the thread continues with its previous settings.
+ *  \retval false   At least one of the settings could not be applied. */
+bool ThreadPolicy::Apply(void) const
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ bool result = true;
+
+ if (myCpus) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (unsigned cpu = 0; cpu < MAX_CPUS; ++cpu) {
+        if (myCpus & ((uint64_t)1 << cpu)) {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (error) {
+        DEBUG_OUT("Could not set CPU affinity 0x" << std::hex << myCpus << std::dec << ": " << strerror(error));
+        result = false;
+    } else {
+        SYS_DEBUG(DL_INFO1, "CPU affinity is set to 0x" << std::hex << myCpus << std::dec);
+    }
+ }
+
+ if (hasScheduling) {
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = myPriority;
+    int error = pthread_setschedparam(pthread_self(), myPolicy, &param);
+    if (error) {
+        DEBUG_OUT("Could not set scheduling policy " << myPolicy << ", priority " << myPriority << ": " << strerror(error));
+        result = false;
+    } else {
+        SYS_DEBUG(DL_INFO1, "Scheduling policy is set to " << myPolicy << ", priority " << myPriority);
+    }
+ }
+
+ return result;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
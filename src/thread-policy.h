@@ -0,0 +1,89 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     CPU affinity and scheduling of the threads
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_THREAD_POLICY_H_INCLUDED__
+#define __GLESLY_SRC_THREAD_POLICY_H_INCLUDED__
+
+#include <stdint.h>
+#include <sched.h>
+
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// CPU affinity and scheduling parameters of a thread
+    /*! The parameters not set are left unchanged when the policy is applied. For example, the
+     *  Render Thread can be pinned to a core which is not used by other busy threads (e.g. the
+     *  rasterizers of the surfaces), and can get a real-time priority:
+     *  \code
+     *  main.SetRenderThreadPolicy(Glesly::ThreadPolicy().AddCpu(3).SetScheduling(SCHED_FIFO, 10));
+     *  \endcode
+     *  \note   The real-time policies need the appropriate privileges (e.g. CAP_SYS_NICE). */
+    class ThreadPolicy
+    {
+     public:
+        inline ThreadPolicy(void):
+            myCpus(0),
+            myPolicy(SCHED_OTHER),
+            myPriority(0),
+            hasScheduling(false)
+        {
+        }
+
+        /// Allows the thread to run on the given CPU
+        /*! It can be called several times to allow more CPUs. */
+        inline ThreadPolicy & AddCpu(unsigned cpu)
+        {
+            ASSERT(cpu < MAX_CPUS, "CPU index is out of range: " << cpu);
+            myCpus |= (uint64_t)1 << cpu;
+            return *this;
+        }
+
+        /// Sets the scheduling policy and the priority
+        /*! \param  policy      E.g. SCHED_OTHER, SCHED_FIFO or SCHED_RR.
+         *  \param  priority    The static priority, it must be 0 for SCHED_OTHER. */
+        inline ThreadPolicy & SetScheduling(int policy, int priority = 0)
+        {
+            myPolicy = policy;
+            myPriority = priority;
+            hasScheduling = true;
+            return *this;
+        }
+
+        inline bool IsEmpty(void) const
+        {
+            return !myCpus && !hasScheduling;
+        }
+
+        bool Apply(void) const;
+
+        static constexpr unsigned MAX_CPUS = 64;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::ThreadPolicy");
+
+        /// Bit mask of the allowed CPUs, 0 means no restriction
+        uint64_t myCpus;
+
+        int myPolicy;
+
+        int myPriority;
+
+        bool hasScheduling;
+
+    }; // class ThreadPolicy
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_THREAD_POLICY_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,245 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Worker threads to execute the Timer functions of the Objects
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "timer-pool.h"
+
+#include <thread>
+#include <algorithm>
+
+#include <glesly/object-base.h>
+#include <glesly/allocation-stats.h>
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class TimerPool:                                                                  *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/// Creates the worker threads
+/*! \param  workers The number of worker threads. If it is zero, one less than the number of
+ *                  CPUs is used, because the calling thread also takes part in the work. */
+TimerPool::TimerPool(unsigned workers):
+    isRunning(false)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!workers) {
+    unsigned cpus = std::thread::hardware_concurrency();
+    workers = cpus > 1 ? cpus - 1 : 1;
+ }
+
+ myShared.reset(new Shared(workers + 1));
+
+ for (unsigned i = 1; i <= workers; ++i) {
+    WorkerPtr worker(new Worker(myShared, i));
+    worker->Start(worker, 4*65536);
+    myWorkers.push_back(worker);
+ }
+
+ SYS_DEBUG(DL_INFO1, "Timer pool started with " << workers << " workers");
+}
+
+TimerPool::~TimerPool()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (isRunning) {
+    try {
+        Finish();
+    } catch (...) {
+        // Note that exception is not allowed here:
+        DEBUG_OUT("ERROR in TimerPool::~TimerPool(): a timer has thrown an exception");
+    }
+ }
+
+ myShared->myFinish = true;
+
+ for (unsigned i = 0; i < myWorkers.size(); ++i) {
+    myWorkers[i]->myStart.Post();
+ }
+}
+
+/// Starts executing the timers of the given objects
+/*! The objects are partitioned equally between the workers and the calling thread, and the
+ *  workers are started. The function returns immediately.
+ *  \note   The array and the objects must be kept valid until \ref TimerPool::Finish() returns. */
+void TimerPool::Start(ObjectBase * const * objects, size_t count)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ASSERT(!isRunning, "TimerPool::Start() called twice");
+
+ Shared & shared = *myShared;
+ size_t slices = shared.mySlices.size();
+
+ shared.myObjects = objects;
+ for (size_t i = 0; i < slices; ++i) {
+    Slice & slice = shared.mySlices[i];
+    slice.next.store(count * i / slices, std::memory_order_relaxed);
+    slice.end = count * (i + 1) / slices;
+ }
+ shared.myPending.store(myWorkers.size(), std::memory_order_relaxed);
+
+ isRunning = true;
+
+ for (unsigned i = 0; i < myWorkers.size(); ++i) {
+    myWorkers[i]->myStart.Post();
+ }
+}
+
+/// Takes part in the work, and waits for the workers
+/*! The calling thread executes its own slice first, then helps the others.<br>
+ *  If a timer has thrown an exception (in any thread), the first one is thrown here, after
+ *  all of the workers have finished. */
+void TimerPool::Finish(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ASSERT(isRunning, "TimerPool::Finish() called without Start()");
+
+ Shared & shared = *myShared;
+
+ try {
+    shared.Execute(0);
+ } catch (...) {
+    shared.SetError(std::current_exception());
+ }
+
+ if (!myWorkers.empty()) {
+    shared.myDone.Wait();
+ }
+
+ isRunning = false;
+
+ if (shared.hasError) {
+    std::exception_ptr error;
+    error.swap(shared.myError);
+    shared.hasError = false;
+    std::rethrow_exception(error);
+ }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     struct TimerPool::Shared:                                                         *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+TimerPool::Shared::Shared(unsigned slices):
+    myObjects(nullptr),
+    mySlices(slices),
+    myPending(0),
+    myFinish(false),
+    hasError(false)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ for (size_t i = 0; i < slices; ++i) {
+    mySlices[i].next = 0;
+    mySlices[i].end = 0;
+ }
+}
+
+/// Executes the own slice, then steals from the others
+/*! \param  own     The index of the own slice. */
+void TimerPool::Shared::Execute(unsigned own)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ size_t slices = mySlices.size();
+
+ for (size_t i = 0; i < slices; ++i) {
+    if (ExecuteSlice(mySlices[(own + i) % slices]) && i) {
+        SYS_DEBUG(DL_INFO3, "Slice #" << own << " stolen work from #" << (own + i) % slices);
+    }
+ }
+}
+
+/// Keeps the first exception thrown by the timers (any thread)
+void TimerPool::Shared::SetError(const std::exception_ptr & error)
+{
+ if (!hasError.exchange(true)) {
+    myError = error;
+ }
+}
+
+/// Executes the remaining objects of one slice
+/*! The objects are taken in chunks, so the owner and the thieves can work on the same slice
+ *  at the same time.
+ *  \retval true    At least one chunk has been executed by this thread. */
+bool TimerPool::Shared::ExecuteSlice(Slice & slice)
+{
+ bool executed = false;
+
+ for (;;) {
+    size_t first = slice.next.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+    if (first >= slice.end) {
+        return executed;
+    }
+    size_t last = std::min(first + CHUNK_SIZE, slice.end);
+    for (size_t i = first; i < last; ++i) {
+        myObjects[i]->Timer();
+    }
+    executed = true;
+ }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class TimerPool::Worker:                                                          *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+TimerPool::Worker::Worker(const SharedPtr & shared, unsigned index):
+    Threads::Thread("TimerWorker"),
+    myShared(shared),
+    myIndex(index)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+TimerPool::Worker::~Worker()
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+}
+
+int TimerPool::Worker::main(void)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ AllocationStats::Scope allocations(AllocationStats::SUBSYSTEM_TIMER);
+
+ SharedPtr shared = myShared;
+
+ for (;;) {
+    myStart.Wait();
+
+    if (ToBeFinished() || shared->myFinish) {
+        break;
+    }
+
+    // The slice must be counted as done anyway, else Finish() would wait forever:
+    try {
+        shared->Execute(myIndex);
+    } catch (...) {
+        shared->SetError(std::current_exception());
+    }
+
+    if (shared->myPending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        shared->myDone.Post();
+    }
+ }
+
+ return 0;
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,139 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Worker threads to execute the Timer functions of the Objects
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_TIMER_POOL_H_INCLUDED__
+#define __GLESLY_SRC_TIMER_POOL_H_INCLUDED__
+
+#include <atomic>
+#include <vector>
+#include <exception>
+
+#include <Threads/Threads.h>
+#include <Threads/Semaphore.h>
+#include <Memory/Memory.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    class ObjectBase;
+
+    /// Worker threads to call \ref ObjectBase::Timer() in parallel
+    /*! The array of objects is partitioned between the workers and the calling thread. When one
+     *  of them finishes its own part, it steals chunks from the others, so the slow timers do
+     *  not block the whole pool.<br>
+     *  Only the objects marked by \ref ObjectBase::IsTimerThreadSafe() may be passed here.
+     *  \note   One pool can be shared by several Renders, but it can execute only one array of
+     *          objects at a time. */
+    class TimerPool
+    {
+     public:
+        TimerPool(unsigned workers = 0);
+        virtual ~TimerPool();
+
+        void Start(ObjectBase * const * objects, size_t count);
+        void Finish(void);
+
+        inline void Run(ObjectBase * const * objects, size_t count)
+        {
+            Start(objects, count);
+            Finish();
+        }
+
+        inline unsigned GetWorkers(void) const
+        {
+            return myWorkers.size();
+        }
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::TimerPool");
+
+        /// The number of objects taken at once from a slice
+        static constexpr size_t CHUNK_SIZE = 8;
+
+        /// One part of the object array
+        struct Slice
+        {
+            std::atomic<size_t> next;
+
+            size_t end;
+
+            /// Keeps the slices in separate cache lines
+            char padding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+        }; // struct Glesly::TimerPool::Slice
+
+        /// The data shared with the workers
+        /*! The workers keep a reference to it, so it remains valid until all of them exit. */
+        struct Shared
+        {
+            Shared(unsigned slices);
+
+            void Execute(unsigned own);
+            bool ExecuteSlice(Slice & slice);
+            void SetError(const std::exception_ptr & error);
+
+            ObjectBase * const * myObjects;
+
+            std::vector<Slice> mySlices;
+
+            std::atomic<unsigned> myPending;
+
+            Threads::Semaphore myDone;
+
+            std::atomic<bool> myFinish;
+
+            /// Set by the first exception of the timers, see \ref TimerPool::Finish()
+            std::atomic<bool> hasError;
+
+            std::exception_ptr myError;
+
+        }; // struct Glesly::TimerPool::Shared
+
+        typedef MEM::shared_ptr<Shared> SharedPtr;
+
+        class Worker: public Threads::Thread
+        {
+         public:
+            Worker(const SharedPtr & shared, unsigned index);
+            virtual ~Worker();
+
+            Threads::Semaphore myStart;
+
+         protected:
+            virtual int main(void) override;
+
+            SharedPtr myShared;
+
+            unsigned myIndex;
+
+         private:
+            SYS_DEFINE_CLASS_NAME("Glesly::TimerPool::Worker");
+
+        }; // class Glesly::TimerPool::Worker
+
+        typedef MEM::shared_ptr<Worker> WorkerPtr;
+
+        SharedPtr myShared;
+
+        std::vector<WorkerPtr> myWorkers;
+
+        bool isRunning;
+
+    }; // class TimerPool
+
+    typedef MEM::shared_ptr<TimerPool> TimerPoolPtr;
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_TIMER_POOL_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,143 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Hierarchical timer wheel for the Object timers
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "timer-wheel.h"
+
+using namespace Glesly;
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *\
+ *                                                                                       *
+ *     class TimerWheel:                                                                 *
+ *                                                                                       *
+\* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+TimerWheel::TimerWheel(void):
+    myTick(0),
+    mySize(0)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ // Each buffer is either in a slot or here:
+ mySpares.reserve(LEVELS * SLOTS);
+}
+
+/// Sets the actual time, the wheel must be empty
+void TimerWheel::Reset(uint64_t tick)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ ASSERT(!mySize, "the timer wheel is not empty: " << mySize);
+
+ myTick = tick;
+}
+
+/// Registers a timer
+/*! \note   The timers already expired are executed at the next tick. */
+void TimerWheel::Add(const Entry & entry)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (entry.due > myTick) {
+    Insert(entry);
+ } else {
+    Entry next = entry;
+    next.due = myTick + 1;
+    Insert(next);
+ }
+
+ ++mySize;
+}
+
+/// Puts the timer to the lowest level where its slot comes before the wheel turns around
+void TimerWheel::Insert(const Entry & entry)
+{
+ unsigned level = 0;
+ while (level < LEVELS - 1 && (entry.due >> (SHIFT * (level + 1))) != (myTick >> (SHIFT * (level + 1)))) {
+    ++level;
+ }
+
+ // On the highest level, the timers further than one turn are cascaded more than once:
+ std::vector<Entry> & slot = mySlots[level][(entry.due >> (SHIFT * level)) & (SLOTS - 1)];
+ if (!slot.capacity() && !mySpares.empty()) {
+    slot.swap(mySpares.back());
+    mySpares.pop_back();
+ }
+ slot.push_back(entry);
+}
+
+/// Gives the buffer of the emptied slot to the spares
+void TimerWheel::Release(std::vector<Entry> & slot)
+{
+ if (slot.capacity()) {
+    mySpares.push_back(std::vector<Entry>());
+    mySpares.back().swap(slot);
+ }
+}
+
+/// Moves the timers of the actual slot of the level to the lower levels
+void TimerWheel::Cascade(unsigned level)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ std::vector<Entry> & slot = mySlots[level][(myTick >> (SHIFT * level)) & (SLOTS - 1)];
+
+ // On the highest level, the entries can be put back to the same slot, so the vector may
+ // grow meanwhile and it is indexed here:
+ size_t count = slot.size();
+ for (size_t i = 0; i < count; ++i) {
+    Entry entry = slot[i];
+    Insert(entry);
+ }
+
+ slot.erase(slot.begin(), slot.begin() + count);
+ if (slot.empty()) {
+    Release(slot);
+ }
+}
+
+/// Collects the timers expired until the given tick
+/*! \param  tick    The actual tick, see \ref TimerWheel::ToTick().
+ *  \param  due     The expired timers are appended here. They are removed from the wheel, the
+ *                  periodic ones must be added again by the caller. */
+void TimerWheel::Advance(uint64_t tick, std::vector<Entry> & due)
+{
+ SYS_DEBUG_MEMBER(DM_GLESLY);
+
+ if (!mySize) {
+    // Nothing to do in the skipped ticks:
+    if (tick > myTick) {
+        myTick = tick;
+    }
+    return;
+ }
+
+ while (myTick < tick && mySize) {
+    ++myTick;
+
+    // The higher levels first, so the timers can move down more than one level:
+    for (unsigned level = LEVELS - 1; level > 0; --level) {
+        if (!(myTick & ((1ULL << (SHIFT * level)) - 1))) {
+            Cascade(level);
+        }
+    }
+
+    std::vector<Entry> & slot = mySlots[0][myTick & (SLOTS - 1)];
+    mySize -= slot.size();
+    due.insert(due.end(), slot.begin(), slot.end());
+    slot.clear();
+    Release(slot);
+ }
+
+ if (tick > myTick) {
+    myTick = tick;
+ }
+}
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */
@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *
+ * Project:     Glesly: my GLES-based rendering library
+ * Purpose:     Hierarchical timer wheel for the Object timers
+ * Author:      György Kövesdi (kgy@teledigit.eu)
+ * Licence:     GPL (see file 'COPYING' in the project root for more details)
+ * Comments:    
+ *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __GLESLY_SRC_TIMER_WHEEL_H_INCLUDED__
+#define __GLESLY_SRC_TIMER_WHEEL_H_INCLUDED__
+
+#include <stdint.h>
+#include <vector>
+
+#include <glesly/object-ptr.h>
+#include <glesly/clock.h>
+#include <Debug/Debug.h>
+
+SYS_DECLARE_MODULE(DM_GLESLY);
+
+namespace Glesly
+{
+    /// Hierarchical timer wheel, see \ref ObjectBase::SetTimerPeriod()
+    /*! The time is measured in ticks of \ref TimerWheel::TICK. Each level has
+     *  \ref TimerWheel::SLOTS slots, one slot of a level covers a whole turn of the level below.
+     *  The timers far in the future are put on the higher levels, and moved down (cascaded) when
+     *  their turn comes, so the cost of \ref TimerWheel::Advance() depends on the number of the
+     *  due timers, not on the number of all of them.
+     *  \note   It is not thread safe, it is used by the Timer Thread only. */
+    class TimerWheel
+    {
+     public:
+        /// One registered timer
+        struct Entry
+        {
+            Glesly::ObjectWeak object;
+
+            /// The generation of the registration, see \ref ObjectBase::myTimerGeneration
+            uint32_t generation;
+
+            /// The period in ticks, 0 means one-shot
+            uint64_t period;
+
+            /// The tick when it expires
+            uint64_t due;
+
+        }; // struct Glesly::TimerWheel::Entry
+
+        TimerWheel(void);
+
+        void Reset(uint64_t tick);
+        void Add(const Entry & entry);
+        void Advance(uint64_t tick, std::vector<Entry> & due);
+
+        /// The last processed tick
+        inline uint64_t GetTick(void) const
+        {
+            return myTick;
+        }
+
+        inline size_t GetSize(void) const
+        {
+            return mySize;
+        }
+
+        /// Converts the time to ticks
+        static inline uint64_t ToTick(int64_t time)
+        {
+            return (uint64_t)(time / TICK);
+        }
+
+        /// The resolution of the wheel: 10 ms
+        static constexpr int64_t TICK = 10 * Clock::NSEC_PER_MSEC;
+
+        static constexpr unsigned SHIFT = 6;
+
+        static constexpr unsigned SLOTS = 1U << SHIFT;
+
+        static constexpr unsigned LEVELS = 3;
+
+     private:
+        SYS_DEFINE_CLASS_NAME("Glesly::TimerWheel");
+
+        void Insert(const Entry & entry);
+        void Cascade(unsigned level);
+        void Release(std::vector<Entry> & slot);
+
+        std::vector<Entry> mySlots[LEVELS][SLOTS];
+
+        /// The buffers of the emptied slots, reused by the slots coming next
+        /*! The wheel turns to new slots continuously, the buffers are moved to them instead of
+         *  allocating new ones in each slot. */
+        std::vector<std::vector<Entry> > mySpares;
+
+        uint64_t myTick;
+
+        size_t mySize;
+
+    }; // class TimerWheel
+
+} // namespace Glesly
+
+#endif /* __GLESLY_SRC_TIMER_WHEEL_H_INCLUDED__ */
+
+/* * * * * * * * * * * * * End - of - File * * * * * * * * * * * * * * */